@@ -1,22 +1,17 @@
 #include "agents/AStarAgent.h"
 #include <algorithm>
 #include <limits>
-#include <cmath>
 
 namespace ml {
 
-static int manh(CellPos a, CellPos b) {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
-}
-
 void AStarAgent::Reset(CellPos start, CellPos exit) {
     AgentBase::Reset(start, exit);
     m_phase = Phase::Explore;
-    m_open = {};
-    m_prev.assign(static_cast<size_t>(m_w*m_h), -1);
-    m_g.assign(static_cast<size_t>(m_w*m_h), std::numeric_limits<int>::max()/4);
-    m_closed.assign(static_cast<size_t>(m_w*m_h), 0u);
-    m_inOpen.assign(static_cast<size_t>(m_w*m_h), 0u);
+    const size_t n = static_cast<size_t>(m_layout.Count());
+    m_open.Reset(n);
+    m_prev.assign(n, -1);
+    m_g.assign(n, std::numeric_limits<int>::max()/4);
+    m_closed.assign(n, 0u);
     m_path.clear();
     ClearFrontier();
 }
@@ -26,17 +21,15 @@ void AStarAgent::Start() {
     if (!m_env) { m_metrics.status = AgentStatus::Fail; return; }
     if (m_env->IsWall(m_start) || m_env->IsWall(m_exit)) { m_metrics.status = AgentStatus::Fail; return; }
 
-    auto idx = [&](CellPos p) { return ToIndex(p.x, p.y, m_w); };
+    auto idx = [&](CellPos p) { return m_layout.Index(p); };
 
-    while (!m_open.empty()) m_open.pop();
+    m_open.Reset(static_cast<size_t>(m_layout.Count()));
     std::fill(m_prev.begin(), m_prev.end(), -1);
     std::fill(m_g.begin(), m_g.end(), std::numeric_limits<int>::max()/4);
     std::fill(m_closed.begin(), m_closed.end(), 0u);
-    std::fill(m_inOpen.begin(), m_inOpen.end(), 0u);
 
     m_g[static_cast<size_t>(idx(m_start))] = 0;
-    m_open.push({manh(m_start, m_exit), 0, m_start});
-    m_inOpen[static_cast<size_t>(idx(m_start))] = 1u;
+    m_open.Push(idx(m_start), Manhattan(m_start, m_exit));
     ClearFrontier();
     SetFrontier(m_start);
 }
@@ -44,7 +37,6 @@ void AStarAgent::Start() {
 void AStarAgent::Tick() {
     if (!IsRunning()) return;
     if (!m_env) { RequestStopFail(); return; }
-    auto idx = [&](CellPos p) { return ToIndex(p.x, p.y, m_w); };
 
     if (m_phase == Phase::Follow) {
         if (m_path.empty()) {
@@ -66,15 +58,11 @@ void AStarAgent::Tick() {
         return;
     }
 
-    // Explore one best node per tick
-    while (!m_open.empty() && m_closed[static_cast<size_t>(idx(m_open.top().p))]) m_open.pop();
-    if (m_open.empty()) { m_metrics.status = AgentStatus::Fail; return; }
+    // Explore one best node per tick (the open list holds no closed cells)
+    if (m_open.Empty()) { m_metrics.status = AgentStatus::Fail; return; }
 
-    Node curN = m_open.top();
-    m_open.pop();
-    CellPos cur = curN.p;
-    int ci = idx(cur);
-    if (m_closed[static_cast<size_t>(ci)]) return;
+    const int ci = m_open.Pop();
+    const CellPos cur = m_layout.Pos(ci);
     m_closed[static_cast<size_t>(ci)] = 1u;
     m_metrics.expanded_nodes++;
 
@@ -86,7 +74,7 @@ void AStarAgent::Tick() {
         std::vector<CellPos> rev;
         int at = ci;
         while (at != -1) {
-            rev.push_back({at % m_w, at / m_w});
+            rev.push_back(m_layout.Pos(at));
             at = m_prev[static_cast<size_t>(at)];
         }
         std::reverse(rev.begin(), rev.end());
@@ -98,18 +86,18 @@ void AStarAgent::Tick() {
 
     ClearFrontier();
     // Mark some open nodes as frontier - cheap: mark neighbors we push
+    const Sense4 s = m_env->SenseWalls4(cur);
     for (Dir d : kDirs) {
+        if (IsBlocked(s, d)) continue;
         CellPos nxt{cur.x + Delta(d).dx, cur.y + Delta(d).dy};
-        if (!m_env->IsFree(nxt)) continue;
-        int ni = idx(nxt);
+        const int ni = m_layout.Step(ci, d);
         if (m_closed[static_cast<size_t>(ni)]) continue;
         int tentativeG = m_g[static_cast<size_t>(ci)] + 1;
         if (tentativeG < m_g[static_cast<size_t>(ni)]) {
             m_g[static_cast<size_t>(ni)] = tentativeG;
             m_prev[static_cast<size_t>(ni)] = ci;
-            int f = tentativeG + manh(nxt, m_exit);
-            m_open.push({f, tentativeG, nxt});
-            m_inOpen[static_cast<size_t>(ni)] = 1u;
+            int f = tentativeG + Manhattan(nxt, m_exit);
+            m_open.Push(ni, f);
             SetFrontier(nxt);
         }
     }
@@ -1,7 +1,7 @@
 #pragma once
 #include "agents/AgentBase.h"
 #include "agents/Environment.h"
-#include <queue>
+#include "core/BucketQueue.h"
 #include <vector>
 #include <deque>
 
@@ -19,22 +19,13 @@ public:
 private:
     enum class Phase { Explore, Follow };
 
-    struct Node { int f; int g; CellPos p; };
-    struct Cmp {
-        bool operator()(const Node& a, const Node& b) const noexcept {
-            if (a.f != b.f) return a.f > b.f;
-            return a.g > b.g;
-        }
-    };
-
     const IFullEnvironment* m_env{nullptr};
     Phase m_phase{Phase::Explore};
 
-    std::priority_queue<Node, std::vector<Node>, Cmp> m_open;
+    BucketQueue<int> m_open; // cell indices by f, newest first on ties
     std::vector<int> m_prev;
     std::vector<int> m_g;
     std::vector<uint8_t> m_closed;
-    std::vector<uint8_t> m_inOpen;
     std::deque<CellPos> m_path;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "agents/IAgent.h"
+#include "core/CellLayout.h"
 #include <chrono>
 
 namespace ml {
@@ -8,8 +9,9 @@ class AgentBase : public IAgent {
 public:
     void OnMazeChanged(int w, int h) override {
         m_w = w; m_h = h;
-        m_visited.assign(static_cast<size_t>(w*h), 0u);
-        m_frontier.assign(static_cast<size_t>(w*h), 0u);
+        m_layout.Reset(w, h);
+        m_visited.assign(static_cast<size_t>(m_layout.Count()), 0u);
+        m_frontier.assign(static_cast<size_t>(m_layout.Count()), 0u);
         m_uniqueVisited = 0;
     }
 
@@ -43,9 +45,8 @@ protected:
     bool IsRunning() const noexcept { return m_running && m_metrics.status == AgentStatus::Running; }
 
     void MarkVisited(CellPos p) {
-        if (m_w <= 0 || m_h <= 0) return;
-        int i = ToIndex(p.x, p.y, m_w);
-        if (i < 0 || i >= m_w*m_h) return;
+        if (!m_layout.InBounds(p)) return;
+        int i = m_layout.Index(p);
         if (m_visited[static_cast<size_t>(i)] == 0u) {
             m_visited[static_cast<size_t>(i)] = 1u;
             m_uniqueVisited++;
@@ -57,9 +58,8 @@ protected:
         std::fill(m_frontier.begin(), m_frontier.end(), 0u);
     }
     void SetFrontier(CellPos p) {
-        if (m_w <= 0 || m_h <= 0) return;
-        int i = ToIndex(p.x, p.y, m_w);
-        if (i < 0 || i >= m_w*m_h) return;
+        if (!m_layout.InBounds(p)) return;
+        int i = m_layout.Index(p);
         m_frontier[static_cast<size_t>(i)] = 1u;
     }
 
@@ -73,6 +73,7 @@ protected:
 
 protected:
     int m_w{0}, m_h{0};
+    CellLayout m_layout; // indexing for the masks and per-agent search arrays
     CellPos m_start{1,1};
     CellPos m_exit{1,1};
     CellPos m_pos{1,1};
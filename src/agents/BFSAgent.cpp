@@ -7,8 +7,8 @@ void BFSAgent::Reset(CellPos start, CellPos exit) {
     AgentBase::Reset(start, exit);
     m_phase = Phase::Explore;
     m_q = {};
-    m_prev.assign(static_cast<size_t>(m_w*m_h), -1);
-    m_seen.assign(static_cast<size_t>(m_w*m_h), 0u);
+    m_prev.assign(static_cast<size_t>(m_layout.Count()), -1);
+    m_seen.assign(static_cast<size_t>(m_layout.Count()), 0u);
     m_path.clear();
     ClearFrontier();
 
@@ -23,12 +23,12 @@ void BFSAgent::Start() {
     if (!m_env) { m_metrics.status = AgentStatus::Fail; return; }
     if (m_env->IsWall(m_start) || m_env->IsWall(m_exit)) { m_metrics.status = AgentStatus::Fail; return; }
 
-    auto idx = [&](CellPos p) { return ToIndex(p.x, p.y, m_w); };
+    const int si = m_layout.Index(m_start);
     m_q = {};
     while (!m_q.empty()) m_q.pop();
     m_q.push(m_start);
-    m_seen[static_cast<size_t>(idx(m_start))] = 1u;
-    m_prev[static_cast<size_t>(idx(m_start))] = -1;
+    m_seen[static_cast<size_t>(si)] = 1u;
+    m_prev[static_cast<size_t>(si)] = -1;
     SetFrontier(m_start);
 }
 
@@ -36,8 +36,6 @@ void BFSAgent::Tick() {
     if (!IsRunning()) return;
     if (!m_env) { RequestStopFail(); return; }
 
-    auto idx = [&](CellPos p) { return ToIndex(p.x, p.y, m_w); };
-
     if (m_phase == Phase::Follow) {
         if (m_path.empty()) {
             // reached
@@ -67,16 +65,17 @@ void BFSAgent::Tick() {
 
     CellPos cur = m_q.front();
     m_q.pop();
+    const int ci = m_layout.Index(cur);
     ClearFrontier(); // simple: recompute sparse frontier by marking queue entries could be expensive; keep minimal
     m_metrics.expanded_nodes++;
 
     if (cur == m_exit) {
         // reconstruct path start->exit
         std::vector<CellPos> rev;
-        int ci = idx(cur);
-        while (ci != -1) {
-            rev.push_back({ci % m_w, ci / m_w});
-            ci = m_prev[static_cast<size_t>(ci)];
+        int at = ci;
+        while (at != -1) {
+            rev.push_back(m_layout.Pos(at));
+            at = m_prev[static_cast<size_t>(at)];
         }
         std::reverse(rev.begin(), rev.end());
 
@@ -91,13 +90,14 @@ void BFSAgent::Tick() {
     // closed set visualization == visited mask; we mark on dequeue
     MarkVisited(cur);
 
+    const Sense4 s = m_env->SenseWalls4(cur);
     for (Dir d : kDirs) {
-        CellPos nxt{cur.x + Delta(d).dx, cur.y + Delta(d).dy};
-        if (!m_env->IsFree(nxt)) continue;
-        int ni = idx(nxt);
+        if (IsBlocked(s, d)) continue;
+        const int ni = m_layout.Step(ci, d);
         if (m_seen[static_cast<size_t>(ni)]) continue;
+        CellPos nxt{cur.x + Delta(d).dx, cur.y + Delta(d).dy};
         m_seen[static_cast<size_t>(ni)] = 1u;
-        m_prev[static_cast<size_t>(ni)] = idx(cur);
+        m_prev[static_cast<size_t>(ni)] = ci;
         m_q.push(nxt);
         SetFrontier(nxt);
     }
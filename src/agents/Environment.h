@@ -9,6 +9,26 @@ struct Sense4 {
     bool n{true}, e{true}, s{true}, w{true};
 };
 
+// Sense4 from a DirBit set of open directions (see Maze::OpenDirs).
+inline Sense4 SenseFromOpenDirs(uint8_t open) {
+    Sense4 s;
+    s.n = (open & DirBit(Dir::N)) == 0;
+    s.e = (open & DirBit(Dir::E)) == 0;
+    s.s = (open & DirBit(Dir::S)) == 0;
+    s.w = (open & DirBit(Dir::W)) == 0;
+    return s;
+}
+
+inline bool IsBlocked(const Sense4& s, Dir d) {
+    switch (d) {
+    case Dir::N: return s.n;
+    case Dir::E: return s.e;
+    case Dir::S: return s.s;
+    case Dir::W: return s.w;
+    default: return true;
+    }
+}
+
 class IPartialEnvironment {
 public:
     virtual ~IPartialEnvironment() = default;
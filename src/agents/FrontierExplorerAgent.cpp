@@ -1,5 +1,4 @@
 #include "agents/FrontierExplorerAgent.h"
-#include <queue>
 #include <vector>
 #include <algorithm>
 
@@ -43,74 +42,70 @@ void FrontierExplorerAgent::UpdateKnowledgeAt(CellPos at) {
     ApplySense(m_kmap, at, s);
 }
 
-bool FrontierExplorerAgent::IsFrontier(CellPos p) const {
-    if (m_kmap.Get(p) != Know::Free) return false;
-    // frontier if has unknown neighbor
-    CellPos n[4] = {{p.x, p.y-1}, {p.x+1,p.y}, {p.x,p.y+1}, {p.x-1,p.y}};
-    for (auto q : n) {
-        if (!m_kmap.InBounds(q)) continue;
-        if (m_kmap.Get(q) == Know::Unknown) return true;
+bool FrontierExplorerAgent::IsFrontier(int idx) const {
+    if (m_kmap.GetAt(idx) != Know::Free) return false;
+    // frontier if has unknown neighbor (the wall ring is never Unknown)
+    const CellLayout& layout = m_kmap.Layout();
+    for (Dir d : kDirs) {
+        if (m_kmap.GetAt(layout.Step(idx, d)) == Know::Unknown) return true;
     }
     return false;
 }
 
 bool FrontierExplorerAgent::FindNearestFrontier(CellPos from, CellPos& outTarget) {
-    const int w = m_w, h = m_h;
-    std::vector<uint8_t> vis(static_cast<size_t>(w*h), 0u);
-    std::queue<CellPos> q;
-    q.push(from);
-    vis[static_cast<size_t>(ToIndex(from.x,from.y,w))] = 1u;
+    const CellLayout& layout = m_kmap.Layout();
+    std::vector<uint8_t> vis(static_cast<size_t>(layout.Count()), 0u);
+    std::vector<int> q;
+    size_t head = 0;
+    q.push_back(layout.Index(from));
+    vis[static_cast<size_t>(q.back())] = 1u;
 
-    while (!q.empty()) {
-        CellPos cur = q.front(); q.pop();
-        if (IsFrontier(cur)) { outTarget = cur; return true; }
+    while (head < q.size()) {
+        const int ci = q[head++];
+        if (IsFrontier(ci)) { outTarget = layout.Pos(ci); return true; }
 
         for (Dir d : kDirs) {
-            CellPos nxt{cur.x + Delta(d).dx, cur.y + Delta(d).dy};
-            if (!m_kmap.InBounds(nxt)) continue;
-            if (m_kmap.Get(nxt) != Know::Free) continue;
-            int ni = ToIndex(nxt.x,nxt.y,w);
+            const int ni = layout.Step(ci, d);
+            if (m_kmap.GetAt(ni) != Know::Free) continue;
             if (vis[static_cast<size_t>(ni)]) continue;
             vis[static_cast<size_t>(ni)] = 1u;
-            q.push(nxt);
+            q.push_back(ni);
         }
     }
     return false;
 }
 
 bool FrontierExplorerAgent::PlanPath(CellPos from, CellPos to) {
-    const int w = m_w, h = m_h;
-    std::vector<int> prev(static_cast<size_t>(w*h), -1);
-    std::queue<CellPos> q;
+    const CellLayout& layout = m_kmap.Layout();
+    std::vector<int> prev(static_cast<size_t>(layout.Count()), -1);
+    std::vector<int> q;
+    size_t head = 0;
 
-    auto idx = [&](CellPos p) { return ToIndex(p.x,p.y,w); };
+    const int fi = layout.Index(from);
+    const int ti = layout.Index(to);
+    q.push_back(fi);
+    prev[static_cast<size_t>(fi)] = fi; // mark as root
 
-    q.push(from);
-    prev[static_cast<size_t>(idx(from))] = idx(from); // mark as root
-
-    while (!q.empty()) {
-        CellPos cur = q.front(); q.pop();
-        if (cur == to) break;
+    while (head < q.size()) {
+        const int ci = q[head++];
+        if (ci == ti) break;
 
         for (Dir d : kDirs) {
-            CellPos nxt{cur.x + Delta(d).dx, cur.y + Delta(d).dy};
-            if (!m_kmap.InBounds(nxt)) continue;
-            if (m_kmap.Get(nxt) != Know::Free) continue;
-            int ni = idx(nxt);
+            const int ni = layout.Step(ci, d);
+            if (m_kmap.GetAt(ni) != Know::Free) continue;
             if (prev[static_cast<size_t>(ni)] != -1) continue;
-            prev[static_cast<size_t>(ni)] = idx(cur);
-            q.push(nxt);
+            prev[static_cast<size_t>(ni)] = ci;
+            q.push_back(ni);
         }
     }
 
-    int ti = idx(to);
     if (prev[static_cast<size_t>(ti)] == -1) return false;
 
     // reconstruct
     std::vector<CellPos> rev;
     int curi = ti;
     while (curi != prev[static_cast<size_t>(curi)]) {
-        rev.push_back({curi % w, curi / w});
+        rev.push_back(layout.Pos(curi));
         curi = prev[static_cast<size_t>(curi)];
     }
     rev.push_back(from);
@@ -23,7 +23,7 @@ private:
     CellPos m_target{-1,-1};
 
     void UpdateKnowledgeAt(CellPos at);
-    bool IsFrontier(CellPos p) const;
+    bool IsFrontier(int idx) const; // idx in m_kmap.Layout()
     bool FindNearestFrontier(CellPos from, CellPos& outTarget);
     bool PlanPath(CellPos from, CellPos to);
 };
@@ -23,7 +23,7 @@ public:
     virtual const AgentMetrics& Metrics() const = 0;
     virtual CellPos Position() const = 0;
 
-    // For rendering overlays (same-size grids, 0/1):
+    // For rendering overlays (0/1 per cell, indexed by CellLayout(w, h)):
     virtual const std::vector<uint8_t>& VisitedMask() const = 0;
     virtual const std::vector<uint8_t>& FrontierMask() const = 0; // optional (may be empty or zeros)
 };
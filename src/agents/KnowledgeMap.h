@@ -2,6 +2,7 @@
 #include <vector>
 #include <cstdint>
 #include "core/Types.h"
+#include "core/CellLayout.h"
 
 namespace ml {
 
@@ -11,11 +12,22 @@ class KnowledgeMap {
 public:
     void Resize(int w, int h) {
         m_w = w; m_h = h;
-        m_cells.assign(static_cast<size_t>(w*h), Know::Unknown);
+        m_layout.Reset(w, h);
+        m_cells.assign(static_cast<size_t>(m_layout.Count()), Know::Unknown);
+        // the padding ring is known wall, so index stepping never needs InBounds
+        for (int x = -1; x <= w; ++x) {
+            m_cells[static_cast<size_t>(m_layout.Index({x, -1}))] = Know::Wall;
+            m_cells[static_cast<size_t>(m_layout.Index({x, h}))] = Know::Wall;
+        }
+        for (int y = 0; y < h; ++y) {
+            m_cells[static_cast<size_t>(m_layout.Index({-1, y}))] = Know::Wall;
+            m_cells[static_cast<size_t>(m_layout.Index({w, y}))] = Know::Wall;
+        }
     }
 
     int Width() const noexcept { return m_w; }
     int Height() const noexcept { return m_h; }
+    const CellLayout& Layout() const noexcept { return m_layout; }
 
     bool InBounds(CellPos p) const noexcept {
         return p.x >= 0 && p.y >= 0 && p.x < m_w && p.y < m_h;
@@ -23,18 +35,22 @@ public:
 
     Know Get(CellPos p) const noexcept {
         if (!InBounds(p)) return Know::Wall;
-        return m_cells[static_cast<size_t>(ToIndex(p.x,p.y,m_w))];
+        return m_cells[static_cast<size_t>(m_layout.Index(p))];
     }
 
     void Set(CellPos p, Know k) {
         if (!InBounds(p)) return;
-        m_cells[static_cast<size_t>(ToIndex(p.x,p.y,m_w))] = k;
+        m_cells[static_cast<size_t>(m_layout.Index(p))] = k;
     }
 
-    const std::vector<Know>& Raw() const noexcept { return m_cells; }
+    // Unchecked access by Layout() index (ring cells read as Wall).
+    Know GetAt(int idx) const noexcept { return m_cells[static_cast<size_t>(idx)]; }
+
+    const std::vector<Know>& Raw() const noexcept { return m_cells; } // Layout() order
 
 private:
     int m_w{0}, m_h{0};
+    CellLayout m_layout;
     std::vector<Know> m_cells;
 };
 
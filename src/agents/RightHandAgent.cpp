@@ -11,16 +11,6 @@ void RightHandAgent::Start() {
     AgentBase::Start();
 }
 
-static bool IsBlocked(const Sense4& s, Dir d) {
-    switch (d) {
-    case Dir::N: return s.n;
-    case Dir::E: return s.e;
-    case Dir::S: return s.s;
-    case Dir::W: return s.w;
-    default: return true;
-    }
-}
-
 void RightHandAgent::Tick() {
     if (!IsRunning()) return;
     if (!m_env) { RequestStopFail(); return; }
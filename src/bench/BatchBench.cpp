@@ -0,0 +1,103 @@
+// Throughput of FindPaths over random free tile pairs on all cores, per
+// pathfinder: queries/s and expanded nodes/s. Runs on a DFS maze and a
+// cellular cave of each side, or straight on a mapped .mlzb file (MazeView,
+// no copy). Only the batch stats are kept, so long paths cost no memory.
+//
+// usage: MazeLabBatchBench [side | file.mlzb ...]   (default: 1023 4095)
+#include "core/MazeFile.h"
+#include "core/RNG.h"
+#include "generators/CellularAutomataGenerator.h"
+#include "generators/RecursiveBacktrackerGenerator.h"
+#include "pathfinding/AStarPathfinder.h"
+#include "pathfinding/BatchPathfinding.h"
+#include "pathfinding/BFSPathfinder.h"
+#include "pathfinding/BidirectionalAStarPathfinder.h"
+#include "pathfinding/BidirectionalBFSPathfinder.h"
+#include "pathfinding/CorridorPathfinder.h"
+#include "pathfinding/HPAPathfinder.h"
+#include "pathfinding/JPSPathfinder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr int kQueries = 4096;
+
+template <ml::MazeGrid Grid>
+void RunBatches(const std::string& label, const Grid& maze) {
+    // random free tile pairs; on caves and files they may lie in different components
+    std::vector<ml::PathQuery> queries(kQueries);
+    ml::RNG rng(maze.Fingerprint());
+    auto freeTile = [&](ml::CellPos& out) {
+        for (int tries = 0; tries < (1 << 20); ++tries) {
+            const ml::CellPos p{rng.NextInt(0, maze.Width() - 1), rng.NextInt(0, maze.Height() - 1)};
+            if (maze.IsFree(p)) {
+                out = p;
+                return true;
+            }
+        }
+        return false;
+    };
+    for (ml::PathQuery& q : queries) {
+        if (!freeTile(q.start) || !freeTile(q.goal)) {
+            std::printf("%-16s no free tiles, skipped\n", label.c_str());
+            return;
+        }
+    }
+
+    std::unique_ptr<ml::IPathfinder> finders[] = {
+        std::make_unique<ml::BFSPathfinder>(),
+        std::make_unique<ml::AStarPathfinder>(),
+        std::make_unique<ml::BidirectionalBFSPathfinder>(),
+        std::make_unique<ml::BidirectionalAStarPathfinder>(),
+        std::make_unique<ml::CorridorPathfinder>(),
+        std::make_unique<ml::JPSPathfinder>(),
+        std::make_unique<ml::HPAPathfinder>(),
+    };
+    for (auto& pf : finders) {
+        const ml::PathBatchStats st = ml::FindPaths(*pf, maze, queries, {});
+        const double meanPath = st.found > 0 ? static_cast<double>(st.pathTiles) / st.found : 0.0;
+        std::printf("%-16s %-18s %6d/%-6d found %3d threads %10.0f queries/s %12.4g expanded/s %10.1f tiles/path\n",
+                    label.c_str(), st.pathfinder.c_str(), st.found, st.queries, st.threads, st.QueriesPerSecond(),
+                    st.ExpandedPerSecond(), meanPath);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.empty()) args = {"1023", "4095"};
+
+    for (const std::string& arg : args) {
+        if (std::string_view(arg).ends_with(".mlzb")) {
+            ml::MazeView view;
+            if (!view.Open(arg)) {
+                std::printf("%s: not a readable .mlzb file\n", arg.c_str());
+                continue;
+            }
+            RunBatches(arg, view);
+            continue;
+        }
+
+        const int side = std::max(std::atoi(arg.c_str()) | 1, 11);
+        ml::MazeGenConfig gc;
+        gc.width = side;
+        gc.height = side;
+        gc.seed = 1;
+        gc.start = {1, 1};
+        gc.exit = {side - 2, side - 2};
+        ml::Maze maze;
+        ml::RecursiveBacktrackerGenerator().Generate(maze, gc);
+        RunBatches("dfs " + std::to_string(side), maze);
+        ml::CellularAutomataGenerator().Generate(maze, gc);
+        RunBatches("cave " + std::to_string(side), maze);
+    }
+    return 0;
+}
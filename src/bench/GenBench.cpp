@@ -0,0 +1,50 @@
+// Generation throughput per generator through GenerateBatch: mazes/s and
+// cells/s for a batch of same-sized mazes on all cores.
+//
+// usage: MazeLabGenBench [count] [side]   (default: 2000 101)
+#include "generators/BatchGeneration.h"
+#include "generators/CellularAutomataGenerator.h"
+#include "generators/EllerGenerator.h"
+#include "generators/KruskalGenerator.h"
+#include "generators/PrimGenerator.h"
+#include "generators/RecursiveBacktrackerGenerator.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const int count = std::max(1, argc > 1 ? std::atoi(argv[1]) : 2000);
+    const int side = std::max(11, argc > 2 ? std::atoi(argv[2]) | 1 : 101);
+
+    std::vector<uint32_t> seeds(static_cast<size_t>(count));
+    std::iota(seeds.begin(), seeds.end(), 1u);
+
+    ml::MazeGenConfig gc;
+    gc.width = side;
+    gc.height = side;
+    gc.start = {1, 1};
+    gc.exit = {side - 2, side - 2};
+
+    std::unique_ptr<ml::IMazeGenerator> gens[] = {
+        std::make_unique<ml::RecursiveBacktrackerGenerator>(),
+        std::make_unique<ml::PrimGenerator>(),
+        std::make_unique<ml::CellularAutomataGenerator>(),
+        std::make_unique<ml::EllerGenerator>(),
+        std::make_unique<ml::KruskalGenerator>(),
+    };
+
+    std::printf("%d mazes of %dx%d, %d threads\n", count, side, side, ml::ThreadPool::Shared().Size());
+    std::printf("%-30s %10s %12s %14s\n", "generator", "ms", "mazes/s", "Mcells/s");
+    ml::MazePool pool;
+    for (auto& gen : gens) {
+        const ml::BatchStats s = ml::GenerateBatch(*gen, gc, seeds, pool);
+        std::printf("%-30s %10.1f %12.0f %14.1f\n", s.generator.c_str(), s.seconds * 1e3, s.MazesPerSecond(),
+                    s.CellsPerSecond() / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Cache misses per expanded node for the pathfinders under the compiled-in
+// TileOrder, on a DFS maze (corridors) and a cellular cave (open areas, where
+// best-first tie-breaking matters). Built twice by CMake (MazeLabBench_rowmajor /
+// MazeLabBench_morton) so both layouts can be compared on the same machine.
+//
+// usage: MazeLabBench [side ...]   (default: 1023 4095)
+#include "bench/PerfCounters.h"
+#include "core/CellLayout.h"
+#include "generators/CellularAutomataGenerator.h"
+#include "generators/RecursiveBacktrackerGenerator.h"
+#include "pathfinding/AStarPathfinder.h"
+#include "pathfinding/BFSPathfinder.h"
+#include "pathfinding/BidirectionalAStarPathfinder.h"
+#include "pathfinding/BidirectionalBFSPathfinder.h"
+#include "pathfinding/CorridorPathfinder.h"
+#include "pathfinding/HPAPathfinder.h"
+#include "pathfinding/JPSPathfinder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+int main(int argc, char** argv) {
+    std::vector<int> sides;
+    for (int i = 1; i < argc; ++i) sides.push_back(std::atoi(argv[i]) | 1);
+    if (sides.empty()) sides = {1023, 4095};
+
+    ml::bench::PerfCounters perf;
+    std::printf("layout=%s perf=%s\n", ml::TileOrder::kName, perf.Available() ? "on" : "off (timing only)");
+    std::printf("%-6s %-5s %-18s %12s %10s %14s %14s\n", "side", "map", "algo", "expanded", "ms", "llc-miss/node",
+                "l1d-miss/node");
+
+    for (int side : sides) for (const char* map : {"dfs", "cave"}) {
+        side = std::max(side, 11);
+        const bool cave = map[0] == 'c';
+        ml::Maze maze;
+        ml::MazeGenConfig gc;
+        gc.width = side;
+        gc.height = side;
+        gc.seed = 1;
+        gc.start = {1, 1};
+        gc.exit = {side - 2, side - 2};
+        if (cave) ml::CellularAutomataGenerator().Generate(maze, gc); // start and exit are joined
+        else ml::RecursiveBacktrackerGenerator().Generate(maze, gc);
+
+        std::unique_ptr<ml::IPathfinder> finders[] = {
+            std::make_unique<ml::BFSPathfinder>(),
+            std::make_unique<ml::AStarPathfinder>(),
+            std::make_unique<ml::BidirectionalBFSPathfinder>(),
+            std::make_unique<ml::BidirectionalAStarPathfinder>(),
+            std::make_unique<ml::CorridorPathfinder>(),
+            std::make_unique<ml::JPSPathfinder>(),
+            std::make_unique<ml::HPAPathfinder>(),
+        };
+        for (auto& pf : finders) {
+            // best of 3 to keep page faults of the first run out of the numbers
+            double bestMs = 1e300;
+            uint64_t llc = 0, l1d = 0;
+            int expanded = 0;
+            for (int rep = 0; rep < 3; ++rep) {
+                perf.Start();
+                const auto t0 = std::chrono::steady_clock::now();
+                const ml::PathResult r = pf->FindPath(maze, gc.start, gc.exit);
+                const auto t1 = std::chrono::steady_clock::now();
+                perf.Stop();
+                const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+                if (ms < bestMs) {
+                    bestMs = ms;
+                    llc = perf.CacheMisses();
+                    l1d = perf.L1DMisses();
+                    expanded = r.expandedNodes;
+                }
+            }
+            const double n = std::max(expanded, 1);
+            if (perf.Available()) {
+                std::printf("%-6d %-5s %-18s %12d %10.2f %14.3f %14.3f\n", side, map, pf->Name().c_str(), expanded,
+                            bestMs, static_cast<double>(llc) / n, static_cast<double>(l1d) / n);
+            } else {
+                std::printf("%-6d %-5s %-18s %12d %10.2f %14s %14s\n", side, map, pf->Name().c_str(), expanded, bestMs,
+                            "n/a", "n/a");
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ml::bench {
+
+// Hardware cache-miss counters for the calling thread (Linux perf_event_open).
+// Elsewhere, or when perf is not permitted (perf_event_paranoid), Available()
+// is false and the readings stay 0.
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        m_llc = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        m_l1d = Open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+    }
+    ~PerfCounters() {
+#if defined(__linux__)
+        if (m_llc >= 0) close(m_llc);
+        if (m_l1d >= 0) close(m_l1d);
+#endif
+    }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool Available() const noexcept { return m_llc >= 0 || m_l1d >= 0; }
+
+    void Start() {
+#if defined(__linux__)
+        const int fds[] = {m_llc, m_l1d};
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    void Stop() {
+#if defined(__linux__)
+        m_cacheMisses = Read(m_llc);
+        m_l1dMisses = Read(m_l1d);
+#endif
+    }
+
+    uint64_t CacheMisses() const noexcept { return m_cacheMisses; } // last-level
+    uint64_t L1DMisses() const noexcept { return m_l1dMisses; }
+
+private:
+#if defined(__linux__)
+    static int Open(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    static uint64_t Read(int fd) {
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t v = 0;
+        if (read(fd, &v, sizeof(v)) != static_cast<ssize_t>(sizeof(v))) v = 0;
+        return v;
+    }
+#endif
+
+    int m_llc{-1};
+    int m_l1d{-1};
+    uint64_t m_cacheMisses{0};
+    uint64_t m_l1dMisses{0};
+};
+
+} // namespace ml::bench
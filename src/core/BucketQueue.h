@@ -0,0 +1,105 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ml {
+
+// Open list for searches whose priorities are small non-negative integers
+// (A* on a unit-cost grid: f = g + h takes few distinct values and never
+// drops below the last pop with a consistent heuristic). Items are dense
+// indices in [0, capacity). Each item is queued at most once: pushing a queued
+// item moves it to the new priority (decrease-key), so there are no stale
+// duplicates to skip. Buckets are intrusive lists popped newest first, which
+// breaks f ties depth-first. Push and Pop are O(1) amortized; Reset() costs
+// only the buckets used, queued flags are epoch stamps like SearchWorkspace.
+template <class IndexT = int>
+class BucketQueue {
+public:
+    static constexpr IndexT kNone = static_cast<IndexT>(-1);
+
+    // Empties the queue and makes room for items [0, capacity).
+    void Reset(size_t capacity) {
+        for (size_t b = m_lo; b < m_hi; ++b) m_heads[b] = kNone;
+        m_lo = m_heads.size();
+        m_hi = 0;
+        m_cursor = 0;
+        m_size = 0;
+        if (capacity > m_links.size()) m_links.resize(capacity, Link{});
+        if (++m_epoch == 0) {
+            std::fill(m_links.begin(), m_links.end(), Link{});
+            m_epoch = 1;
+        }
+    }
+
+    bool Empty() const noexcept { return m_size == 0; }
+    size_t Size() const noexcept { return m_size; }
+    bool Contains(IndexT i) const noexcept { return m_links[static_cast<size_t>(i)].stamp == m_epoch; }
+
+    // Queues i at priority p (>= 0), or moves it there if already queued.
+    void Push(IndexT i, int priority) {
+        Link& l = m_links[static_cast<size_t>(i)];
+        if (l.stamp == m_epoch) {
+            if (l.priority == priority) return;
+            Unlink(i);
+        }
+        const size_t b = static_cast<size_t>(priority);
+        if (b >= m_heads.size()) m_heads.resize(std::max(b + 1, m_heads.size() * 2), kNone);
+        l.stamp = m_epoch;
+        l.priority = priority;
+        l.prev = kNone;
+        l.next = m_heads[b];
+        if (l.next != kNone) m_links[static_cast<size_t>(l.next)].prev = i;
+        m_heads[b] = i;
+        ++m_size;
+        m_lo = std::min(m_lo, b);
+        m_hi = std::max(m_hi, b + 1);
+        m_cursor = std::min(m_cursor, b);
+    }
+
+    // Lowest priority; call only when not Empty().
+    int TopPriority() {
+        Advance();
+        return static_cast<int>(m_cursor);
+    }
+
+    // Removes and returns the newest item of the lowest priority (not Empty()).
+    IndexT Pop() {
+        Advance();
+        const IndexT i = m_heads[m_cursor];
+        Unlink(i);
+        return i;
+    }
+
+private:
+    struct Link {
+        uint32_t stamp{0}; // epoch in which the item was queued, 0 = never
+        int priority{0};
+        IndexT prev{kNone};
+        IndexT next{kNone};
+    };
+
+    void Advance() noexcept {
+        while (m_heads[m_cursor] == kNone) ++m_cursor;
+    }
+
+    void Unlink(IndexT i) noexcept {
+        Link& l = m_links[static_cast<size_t>(i)];
+        if (l.prev != kNone) m_links[static_cast<size_t>(l.prev)].next = l.next;
+        else m_heads[static_cast<size_t>(l.priority)] = l.next;
+        if (l.next != kNone) m_links[static_cast<size_t>(l.next)].prev = l.prev;
+        l.stamp = 0;
+        --m_size;
+    }
+
+    std::vector<IndexT> m_heads; // per priority, newest item first
+    std::vector<Link> m_links;
+    size_t m_lo{0};     // buckets [m_lo, m_hi) may be in use
+    size_t m_hi{0};
+    size_t m_cursor{0}; // no item below this priority
+    size_t m_size{0};
+    uint32_t m_epoch{0};
+};
+
+} // namespace ml
@@ -0,0 +1,164 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include "core/Types.h"
+#include "core/Directions.h"
+
+#ifndef MAZELAB_CELL_ORDER_MORTON
+#define MAZELAB_CELL_ORDER_MORTON 0
+#endif
+
+namespace ml {
+
+// Cell order inside a 64x64 tile. A local index is SpreadX(lx) | SpreadY(ly) with
+// disjoint x/y bit masks, so CellLayout::Step can move along one axis with
+// masked add/sub whatever the order is.
+struct RowMajorTileOrder {
+    static constexpr const char* kName = "row-major";
+    static constexpr int kXMask = 0x03F;
+    static constexpr int kYMask = 0xFC0;
+
+    static constexpr int SpreadX(int lx) noexcept { return lx; }
+    static constexpr int SpreadY(int ly) noexcept { return ly << 6; }
+    static constexpr int CompactX(int local) noexcept { return local & kXMask; }
+    static constexpr int CompactY(int local) noexcept { return local >> 6; }
+};
+
+// Z-order: x in the even bits, y in the odd bits. Vertical neighbours are at
+// most a few cache lines away instead of a full 64-cell row.
+struct MortonTileOrder {
+    static constexpr const char* kName = "morton";
+    static constexpr int kXMask = 0x555;
+    static constexpr int kYMask = 0xAAA;
+
+    static constexpr int Part1By1(int v) noexcept {
+        v &= 0x3F;
+        v = (v | (v << 4)) & 0x30F;
+        v = (v | (v << 2)) & 0x333;
+        return (v | (v << 1)) & 0x555;
+    }
+    static constexpr int Compact1By1(int v) noexcept {
+        v &= 0x555;
+        v = (v | (v >> 1)) & 0x333;
+        v = (v | (v >> 2)) & 0x30F;
+        return (v | (v >> 4)) & 0x3F;
+    }
+    static constexpr int SpreadX(int lx) noexcept { return Part1By1(lx); }
+    static constexpr int SpreadY(int ly) noexcept { return Part1By1(ly) << 1; }
+    static constexpr int CompactX(int local) noexcept { return Compact1By1(local); }
+    static constexpr int CompactY(int local) noexcept { return Compact1By1(local >> 1); }
+};
+
+// Chosen at build time (CMake option MAZELAB_MORTON_TILES).
+#if MAZELAB_CELL_ORDER_MORTON
+using TileOrder = MortonTileOrder;
+#else
+using TileOrder = RowMajorTileOrder;
+#endif
+
+// Flat cell indexing for a w x h grid padded with a one-cell ring on every side.
+// Index() is valid for -1 <= x <= w and -1 <= y <= h, so every neighbour of an
+// in-bounds cell has an index and Step() needs no bounds check.
+//
+// The padded grid is cut into 64x64 tiles stored one after another (tile-major,
+// TileOrder inside a tile): idx >> (2 * kTileShift) is the tile slot, which is
+// how Maze finds its lazily allocated chunk for an index. Arrays indexed this way
+// are sized Count(); the index space must fit in int, so neither side may exceed
+// kMaxSide. Maze storage is addressed by tile and goes further (Maze::kMaxSide);
+// a larger Maze simply has no layout (Maze::Indexed()).
+class CellLayout {
+public:
+    static constexpr int kTileShift = 6;
+    static constexpr int kTileSide = 1 << kTileShift;
+    static constexpr int kTileMask = kTileSide - 1;
+    static constexpr int kTileCells = kTileSide * kTileSide;
+
+    // 724 x 724 tiles of 4096 cells is the largest square grid below INT_MAX.
+    static constexpr int kMaxTilesPerSide = 724;
+    static constexpr int kMaxSide = kMaxTilesPerSide * kTileSide - 2;
+
+    CellLayout() = default;
+    CellLayout(int w, int h) { Reset(w, h); }
+
+    void Reset(int w, int h) {
+        m_w = w;
+        m_h = h;
+        assert(w <= kMaxSide && h <= kMaxSide);
+        m_tileCols = (w + 2 + kTileMask) >> kTileShift;
+        m_tileRows = (h + 2 + kTileMask) >> kTileShift;
+        m_count = m_tileCols * m_tileRows * kTileCells;
+        m_tileRowStep = m_tileCols * kTileCells;
+    }
+
+    int Width() const noexcept { return m_w; }
+    int Height() const noexcept { return m_h; }
+    int Count() const noexcept { return m_count; }
+    int TileCols() const noexcept { return m_tileCols; }
+    int TileRows() const noexcept { return m_tileRows; }
+
+    bool InBounds(CellPos p) const noexcept {
+        return p.x >= 0 && p.y >= 0 && p.x < m_w && p.y < m_h;
+    }
+    bool InPadded(CellPos p) const noexcept {
+        return p.x >= -1 && p.y >= -1 && p.x <= m_w && p.y <= m_h;
+    }
+
+    // Position inside a tile, from padded coordinates.
+    static int LocalIndex(int px, int py) noexcept {
+        return TileOrder::SpreadX(px & kTileMask) | TileOrder::SpreadY(py & kTileMask);
+    }
+
+    int Index(CellPos p) const noexcept {
+        const int px = p.x + 1;
+        const int py = p.y + 1;
+        const int tile = (py >> kTileShift) * m_tileCols + (px >> kTileShift);
+        return (tile << (2 * kTileShift)) | LocalIndex(px, py);
+    }
+
+    CellPos Pos(int idx) const noexcept {
+        const int tile = idx >> (2 * kTileShift);
+        const int ty = tile / m_tileCols;
+        const int tx = tile - ty * m_tileCols;
+        const int local = idx & (kTileCells - 1);
+        return {(tx << kTileShift) + TileOrder::CompactX(local) - 1, (ty << kTileShift) + TileOrder::CompactY(local) - 1};
+    }
+
+    int Step(int idx, Dir d) const noexcept {
+        // Inside a tile: masked add/sub on one axis (filling the other axis' bits
+        // makes the carry skip them). Crossing an edge wraps that axis and moves
+        // to the neighbouring tile.
+        constexpr int xm = TileOrder::kXMask;
+        constexpr int ym = TileOrder::kYMask;
+        constexpr int xOne = xm & -xm;
+        constexpr int yOne = ym & -ym;
+        switch (d) {
+        case Dir::N:
+            return (idx & ym) != 0 ? (((idx & ym) - yOne) & ym) | (idx & ~ym)
+                                   : (idx | ym) - m_tileRowStep;
+        case Dir::E:
+            return (idx & xm) != xm ? (((idx | ym) + xOne) & xm) | (idx & ~xm)
+                                    : (idx & ~xm) + kTileCells;
+        case Dir::S:
+            return (idx & ym) != ym ? (((idx | xm) + yOne) & ym) | (idx & ~ym)
+                                    : (idx & ~ym) + m_tileRowStep;
+        case Dir::W:
+        default:
+            return (idx & xm) != 0 ? (((idx & xm) - xOne) & xm) | (idx & ~xm)
+                                   : (idx | xm) - kTileCells;
+        }
+    }
+
+private:
+    static_assert(int64_t{kMaxTilesPerSide} * kMaxTilesPerSide * kTileCells <= INT_MAX);
+
+    int m_w{0};
+    int m_h{0};
+    int m_tileCols{0};
+    int m_tileRows{0};
+    int m_tileRowStep{0};
+    int m_count{0};
+};
+
+} // namespace ml
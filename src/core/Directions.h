@@ -1,5 +1,7 @@
 #pragma once
 #include <array>
+#include <bit>
+#include <cstdint>
 
 namespace ml {
 
@@ -23,4 +25,8 @@ inline DirDelta Delta(Dir d) {
 
 inline constexpr std::array<Dir, 4> kDirs{Dir::N, Dir::E, Dir::S, Dir::W};
 
+// 4-bit direction sets: bit (1 << Dir). Iterating lowest bit first visits kDirs order.
+inline constexpr uint8_t DirBit(Dir d) { return static_cast<uint8_t>(1u << static_cast<int>(d)); }
+inline Dir FirstDir(uint8_t dirs) { return static_cast<Dir>(std::countr_zero(static_cast<unsigned>(dirs))); }
+
 } // namespace ml
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace ml {
+
+// Union-find root of `a` in a parent array (parent[root] == root), with path
+// halving. Single-threaded; the parallel Kruskal merge keeps its own atomic one.
+inline int FindRoot(std::vector<int>& parent, int a) {
+    while (parent[static_cast<size_t>(a)] != a) {
+        parent[static_cast<size_t>(a)] = parent[static_cast<size_t>(parent[static_cast<size_t>(a)])];
+        a = parent[static_cast<size_t>(a)];
+    }
+    return a;
+}
+
+} // namespace ml
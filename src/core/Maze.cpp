@@ -1,14 +1,63 @@
 #include "core/Maze.h"
+#include "core/MazeComponents.h"
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <type_traits>
 
 namespace ml {
 
+// bit j of a byte -> bit 4 * j (one nibble per cell)
+static constexpr std::array<uint32_t, 256> kSpreadNibbles = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t v = 0; v < 256; ++v) {
+        for (int j = 0; j < 8; ++j) t[v] |= ((v >> j) & 1u) << (4 * j);
+    }
+    return t;
+}();
+
 Maze::Maze(int w, int h) { Resize(w, h); }
 
+Maze::Maze(const Maze& o)
+    : m_w(o.m_w)
+    , m_h(o.m_h)
+    , m_wordsPerRow(o.m_wordsPerRow)
+    , m_tileCols(o.m_tileCols)
+    , m_tileRows(o.m_tileRows)
+    , m_layout(o.m_layout)
+    , m_allocated(o.m_allocated)
+    , m_components(o.m_components)
+    , m_fingerprint(o.m_fingerprint)
+{
+    m_chunks.resize(o.m_chunks.size());
+    for (size_t i = 0; i < o.m_chunks.size(); ++i) {
+        if (o.m_chunks[i]) m_chunks[i] = std::make_unique<Chunk>(*o.m_chunks[i]);
+    }
+}
+
+Maze& Maze::operator=(const Maze& o) {
+    if (this != &o) {
+        Maze tmp(o);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
 void Maze::Resize(int w, int h) {
-    m_w = std::max(3, w);
-    m_h = std::max(3, h);
-    m_wall.assign(static_cast<size_t>(m_w * m_h), 1u);
+    assert(w <= kMaxSide && h <= kMaxSide);
+    m_w = std::clamp(w, 3, kMaxSide);
+    m_h = std::clamp(h, 3, kMaxSide);
+    m_wordsPerRow = (m_w + 63) / 64;
+    m_tileCols = (m_w + 2 + CellLayout::kTileMask) >> CellLayout::kTileShift;
+    m_tileRows = (m_h + 2 + CellLayout::kTileMask) >> CellLayout::kTileShift;
+    // past CellLayout::kMaxSide the int cell indices would overflow: storage only
+    if (m_w <= CellLayout::kMaxSide && m_h <= CellLayout::kMaxSide) m_layout.Reset(m_w, m_h);
+    else m_layout = CellLayout();
+    m_chunks.clear();
+    m_chunks.resize(static_cast<size_t>(m_tileCols) * static_cast<size_t>(m_tileRows));
+    m_allocated = 0;
+    InvalidateDerived();
 }
 
 bool Maze::InBounds(CellPos p) const noexcept {
@@ -17,18 +66,236 @@ bool Maze::InBounds(CellPos p) const noexcept {
 
 bool Maze::IsWall(CellPos p) const noexcept {
     if (!InBounds(p)) return true;
-    return m_wall[static_cast<size_t>(ToIndex(p.x, p.y, m_w))] != 0;
+    const int px = p.x + 1;
+    const int py = p.y + 1;
+    const Chunk* c = FindChunk(px, py);
+    if (!c) return true;
+    return ((c->rows[py & CellLayout::kTileMask] >> (px & CellLayout::kTileMask)) & 1u) == 0;
 }
 
 bool Maze::IsFree(CellPos p) const noexcept { return !IsWall(p); }
 
 void Maze::FillWalls() {
-    std::fill(m_wall.begin(), m_wall.end(), 1u);
+    for (auto& c : m_chunks) c.reset();
+    m_allocated = 0;
+    InvalidateDerived();
+}
+
+void Maze::InvalidateDerived() noexcept {
+    if (m_components) m_components.reset();
+    m_fingerprint = 0;
+}
+
+const MazeComponents& Maze::Components() const {
+    if (!m_components) {
+        auto comps = std::make_shared<MazeComponents>();
+        comps->Build(*this);
+        m_components = std::move(comps);
+    }
+    return *m_components;
+}
+
+Maze::Chunk& Maze::TouchChunk(int px, int py) {
+    auto& c = m_chunks[ChunkSlot(px, py)];
+    if (!c) {
+        c = std::make_unique<Chunk>();
+        m_allocated++;
+    }
+    return *c;
+}
+
+size_t Maze::MemoryBytes() const noexcept {
+    return m_chunks.capacity() * sizeof(std::unique_ptr<Chunk>) + m_allocated * sizeof(Chunk) +
+           (m_components ? m_components->MemoryBytes() : 0u);
 }
 
 void Maze::SetFree(CellPos p, bool free) {
     if (!InBounds(p)) return;
-    m_wall[static_cast<size_t>(ToIndex(p.x, p.y, m_w))] = free ? 0u : 1u;
+    const int px = p.x + 1;
+    const int py = p.y + 1;
+    if (!free && !FindChunk(px, py)) return; // already wall, keep it unallocated
+    uint64_t& row = TouchChunk(px, py).rows[py & CellLayout::kTileMask];
+    const uint64_t bit = uint64_t{1} << (px & CellLayout::kTileMask);
+    if (((row & bit) != 0) == free) return;
+    if (free) row |= bit;
+    else row &= ~bit;
+    OnFreeChanged(p, free);
+}
+
+void Maze::OnFreeChanged(CellPos p, bool free) {
+    // p's own mask is unaffected; each neighbour (ring included) gains/loses the direction back to p.
+    // Neighbour chunks are allocated here, so a cell with a free neighbour always has storage.
+    InvalidateDerived();
+    for (Dir d : kDirs) {
+        const CellPos n = Step(p, d);
+        const int px = n.x + 1;
+        const int py = n.y + 1;
+        Chunk& c = TouchChunk(px, py);
+        const int local = CellLayout::LocalIndex(px, py);
+        const uint8_t bit = static_cast<uint8_t>(DirBit(TurnBack(d)) << ((local & 1) * 4));
+        if (free) c.open[local >> 1] |= bit;
+        else c.open[local >> 1] &= static_cast<uint8_t>(~bit);
+    }
+}
+
+uint64_t Maze::TailMask(int k) const noexcept {
+    // valid bits of word k (only the last word of a row is partial)
+    const int bits = m_w - k * 64;
+    return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1u;
+}
+
+uint64_t Maze::ChunkRow(int tileCol, int py) const noexcept {
+    if (tileCol >= m_tileCols || py < 0 || py >= (m_tileRows << CellLayout::kTileShift)) return 0u;
+    const Chunk* c = FindChunk(tileCol << CellLayout::kTileShift, py);
+    return c ? c->rows[py & CellLayout::kTileMask] : 0u;
+}
+
+uint64_t Maze::RowWord(int y, int k) const noexcept {
+    if (y < 0 || y >= m_h || k < 0 || k >= m_wordsPerRow) return 0u;
+    // tiles k*64 .. k*64+63 sit at padded bits 1..63 of chunk column k and bit 0 of column k+1
+    const int py = y + 1;
+    return (ChunkRow(k, py) >> 1) | (ChunkRow(k + 1, py) << 63);
+}
+
+void Maze::SetRowWord(int y, int k, uint64_t freeBits) {
+    if (y < 0 || y >= m_h || k < 0 || k >= m_wordsPerRow) return;
+    freeBits &= TailMask(k);
+    uint64_t changed = RowWord(y, k) ^ freeBits;
+    if (!changed) return;
+
+    const int py = y + 1;
+    const int r = py & CellLayout::kTileMask;
+    if (changed & ~(uint64_t{1} << 63)) {
+        uint64_t& lo = TouchChunk(k << CellLayout::kTileShift, py).rows[r];
+        lo = (lo & 1u) | (freeBits << 1);
+    }
+    if (changed >> 63) {
+        uint64_t& hi = TouchChunk((k + 1) << CellLayout::kTileShift, py).rows[r];
+        hi = (hi & ~uint64_t{1}) | (freeBits >> 63);
+    }
+    for (; changed; changed &= changed - 1u) {
+        const int i = std::countr_zero(changed);
+        OnFreeChanged({k * 64 + i, y}, ((freeBits >> i) & 1u) != 0);
+    }
+}
+
+void Maze::LoadRows(const uint64_t* freeRows, size_t stride) {
+    LoadRowsFrom(freeRows, stride, 0, m_h);
+}
+
+int Maze::LoadRowsFrom(const uint64_t* freeRows, size_t stride, int y, int rows) {
+    // Chunk row t holds padded rows 64t..64t+63, i.e. tile rows 64t-1..64t+62.
+    // Its open directions are final once row t+1 is in, so they trail by one.
+    if (y == 0) FillWalls();
+    const int t0 = (y + 1) >> CellLayout::kTileShift;
+    const int end = std::min(m_h, y + std::max(1, rows)); // padded rows end at end + 1
+    int t1 = std::max(t0 + 1, (end + 1 + CellLayout::kTileMask) >> CellLayout::kTileShift);
+    if ((t1 << CellLayout::kTileShift) - 1 >= m_h) t1 = m_tileRows; // the rest is padding only
+    for (int t = t0; t < t1; ++t) {
+        LoadChunkRow(freeRows, stride, t);
+        if (t > 0) RebuildChunkRow(t - 1);
+    }
+    if (t1 == m_tileRows) RebuildChunkRow(m_tileRows - 1);
+    InvalidateDerived();
+    return t1 == m_tileRows ? m_h : (t1 << CellLayout::kTileShift) - 1;
+}
+
+void Maze::LoadChunkRow(const uint64_t* freeRows, size_t stride, int tileRow) {
+    // rows into chunks: word k covers padded bits 1..63 of chunk column k and bit 0 of column k + 1
+    const int py0 = std::max(1, tileRow << CellLayout::kTileShift);
+    const int py1 = std::min(m_h + 1, (tileRow + 1) << CellLayout::kTileShift);
+    for (int py = py0; py < py1; ++py) {
+        const int r = py & CellLayout::kTileMask;
+        const uint64_t* src = freeRows + static_cast<size_t>(py - 1) * stride;
+        for (int k = 0; k < m_wordsPerRow; ++k) {
+            const uint64_t word = src[k] & TailMask(k);
+            if (!word) continue;
+            TouchChunk(k << CellLayout::kTileShift, py).rows[r] |= word << 1;
+            if (word >> 63) TouchChunk((k + 1) << CellLayout::kTileShift, py).rows[r] |= 1u;
+        }
+    }
+
+    // Free tiles on a chunk edge give the neighbouring chunk open directions,
+    // so it needs storage too (same rule as OnFreeChanged).
+    const size_t first = static_cast<size_t>(tileRow) * static_cast<size_t>(m_tileCols);
+    std::vector<uint8_t> edges(static_cast<size_t>(m_tileCols), 0u); // DirBit of the sides with free tiles
+    for (int tx = 0; tx < m_tileCols; ++tx) {
+        const Chunk* c = m_chunks[first + static_cast<size_t>(tx)].get();
+        if (!c) continue;
+        uint64_t any = 0u;
+        for (uint64_t row : c->rows) any |= row;
+        uint8_t e = 0u;
+        if (c->rows[0]) e |= DirBit(Dir::N);
+        if (c->rows[CellLayout::kTileMask]) e |= DirBit(Dir::S);
+        if (any & 1u) e |= DirBit(Dir::W);
+        if (any >> 63) e |= DirBit(Dir::E);
+        edges[static_cast<size_t>(tx)] = e;
+    }
+    for (int tx = 0; tx < m_tileCols; ++tx) {
+        for (uint8_t dirs = edges[static_cast<size_t>(tx)]; dirs; dirs &= dirs - 1) {
+            const auto d = Delta(FirstDir(dirs));
+            TouchChunk((tx + d.dx) << CellLayout::kTileShift, (tileRow + d.dy) << CellLayout::kTileShift);
+        }
+    }
+}
+
+void Maze::RebuildChunkRow(int tileRow) {
+    const size_t first = static_cast<size_t>(tileRow) * static_cast<size_t>(m_tileCols);
+    for (int tx = 0; tx < m_tileCols; ++tx) {
+        if (Chunk* c = m_chunks[first + static_cast<size_t>(tx)].get()) RebuildOpenDirs(*c, tx, tileRow);
+    }
+}
+
+void Maze::RebuildOpenDirs(Chunk& c, int tileCol, int tileRow) const noexcept {
+    std::fill(std::begin(c.open), std::end(c.open), uint8_t{0});
+    const int py0 = tileRow << CellLayout::kTileShift;
+    for (int r = 0; r < CellLayout::kTileSide; ++r) {
+        const int py = py0 + r;
+        const uint64_t row = c.rows[r];
+        const uint64_t up = r > 0 ? c.rows[r - 1] : (py > 0 ? ChunkRow(tileCol, py - 1) : 0u);
+        const uint64_t down = r < CellLayout::kTileMask ? c.rows[r + 1] : ChunkRow(tileCol, py + 1);
+        // bit i of west/east = tile west/east of column i is free
+        const uint64_t west = (row << 1) | (tileCol > 0 ? ChunkRow(tileCol - 1, py) >> 63 : 0u);
+        const uint64_t east = (row >> 1) | (ChunkRow(tileCol + 1, py) << 63);
+        uint64_t any = up | down | west | east;
+        if (!any) continue;
+        if constexpr (std::is_same_v<TileOrder, RowMajorTileOrder>) {
+            // a local row is 32 consecutive bytes: spread 8 cells at a time into 8 nibbles
+            for (int q = 0; q < 8; ++q) {
+                const int sh = q * 8;
+                const uint32_t nibs = kSpreadNibbles[(up >> sh) & 0xFFu] << static_cast<int>(Dir::N) |
+                                      kSpreadNibbles[(east >> sh) & 0xFFu] << static_cast<int>(Dir::E) |
+                                      kSpreadNibbles[(down >> sh) & 0xFFu] << static_cast<int>(Dir::S) |
+                                      kSpreadNibbles[(west >> sh) & 0xFFu] << static_cast<int>(Dir::W);
+                uint8_t* dst = c.open + (r << (CellLayout::kTileShift - 1)) + q * 4;
+                for (int b = 0; b < 4; ++b) dst[b] = static_cast<uint8_t>(nibs >> (b * 8));
+            }
+            continue;
+        }
+        for (; any; any &= any - 1u) {
+            const int i = std::countr_zero(any);
+            const uint8_t nib = static_cast<uint8_t>(((up >> i) & 1u) << static_cast<int>(Dir::N) |
+                                                     ((east >> i) & 1u) << static_cast<int>(Dir::E) |
+                                                     ((down >> i) & 1u) << static_cast<int>(Dir::S) |
+                                                     ((west >> i) & 1u) << static_cast<int>(Dir::W));
+            const int local = CellLayout::LocalIndex(i, r);
+            c.open[local >> 1] |= static_cast<uint8_t>(nib << ((local & 1) * 4));
+        }
+    }
+}
+
+uint64_t Maze::Fingerprint() const noexcept {
+    if (!m_fingerprint) m_fingerprint = RowFingerprint(*this); // 0 marks "not computed"
+    return m_fingerprint;
+}
+
+uint8_t Maze::OpenDirs(CellPos p) const noexcept {
+    // beyond the padding ring no neighbour can be in bounds
+    if (m_chunks.empty() || p.x < -1 || p.y < -1 || p.x > m_w || p.y > m_h) return 0u;
+    const int px = p.x + 1;
+    const int py = p.y + 1;
+    const Chunk* c = FindChunk(px, py);
+    return c ? c->Open(CellLayout::LocalIndex(px, py)) : uint8_t{0};
 }
 
 CellPos Maze::Step(CellPos from, Dir dir) const noexcept {
@@ -37,8 +304,7 @@ CellPos Maze::Step(CellPos from, Dir dir) const noexcept {
 }
 
 bool Maze::CanMove(CellPos from, Dir dir) const noexcept {
-    CellPos to = Step(from, dir);
-    return InBounds(to) && IsFree(to);
+    return (OpenDirs(from) & DirBit(dir)) != 0;
 }
 
 bool Maze::IsOddCell(CellPos p) const noexcept {
@@ -1,16 +1,35 @@
 #pragma once
 #include <vector>
+#include <memory>
 #include <cstdint>
 #include "core/Types.h"
 #include "core/Directions.h"
+#include "core/CellLayout.h"
+#include "core/MazeGrid.h"
 
 namespace ml {
 
+class MazeComponents;
+
+// Tile grid. Storage is split into 64x64 chunks (the CellLayout tiles) that are
+// allocated on first write; a chunk that was never touched reads as solid wall,
+// so memory follows the carved/explored area rather than Width() x Height().
+// Chunks are found by tile coordinates, so the CellPos and row-word API works
+// up to kMaxSide; the flat index API (Layout, OpenDirsAt) and the searches
+// built on it need Indexed().
 class Maze {
 public:
+    // 2048 x 2048 chunks; the chunk table alone is 32 MiB at this size.
+    static constexpr int kMaxSide = 2048 * CellLayout::kTileSide - 2;
+
     Maze() = default;
     Maze(int w, int h);
+    Maze(const Maze& o);
+    Maze& operator=(const Maze& o);
+    Maze(Maze&&) noexcept = default;
+    Maze& operator=(Maze&&) noexcept = default;
 
+    // Sides are clamped to 3..kMaxSide (131070); debug builds assert on larger requests.
     void Resize(int w, int h);
     int Width() const noexcept { return m_w; }
     int Height() const noexcept { return m_h; }
@@ -19,9 +38,58 @@ public:
     bool IsWall(CellPos p) const noexcept;
     bool IsFree(CellPos p) const noexcept;
 
-    void FillWalls();
+    void FillWalls(); // also releases all chunks
     void SetFree(CellPos p, bool free);
 
+    // Bit-packed row access: bit i of word k covers tile (k*64 + i, y); 1 = free.
+    // Bits past the right edge are always 0, out-of-range reads return 0 (all wall).
+    int WordsPerRow() const noexcept { return m_wordsPerRow; }
+    uint64_t RowWord(int y, int k) const noexcept;
+    void SetRowWord(int y, int k, uint64_t freeBits);
+    // Replace the whole grid from row words (row y at freeRows + y * stride,
+    // WordsPerRow() words each). Builds chunks and open-direction masks in bulk,
+    // much faster than SetRowWord per word for a freshly generated grid.
+    void LoadRows(const uint64_t* freeRows, size_t stride);
+    // LoadRows a band at a time, for callers that must not block. Start with
+    // y = 0 (which clears the grid) and pass the returned row back in until it
+    // is Height(); each call loads at least `rows` rows, in whole 64-row chunk
+    // rows. The grid is complete only after the last call.
+    int LoadRowsFrom(const uint64_t* freeRows, size_t stride, int y, int rows);
+
+    // Directions (DirBit set) in which the adjacent tile is free. Stored per cell
+    // and kept current by SetFree/SetRowWord, so this is a single load.
+    uint8_t OpenDirs(CellPos p) const noexcept;
+
+    // Index-based access for search loops. Layout() pads the grid with a wall
+    // ring, so Layout().Step(idx, d) needs no bounds check for in-bounds idx and
+    // OpenDirsAt never reports a direction leading off the grid. Only mazes whose
+    // sides fit CellLayout::kMaxSide (46334) have one; Layout() is empty otherwise.
+    bool Indexed() const noexcept { return m_layout.Count() != 0; }
+    const CellLayout& Layout() const noexcept { return m_layout; }
+    uint8_t OpenDirsAt(int idx) const noexcept {
+        const Chunk* c = m_chunks[static_cast<size_t>(idx >> (2 * CellLayout::kTileShift))].get();
+        return c ? c->Open(idx & (CellLayout::kTileCells - 1)) : uint8_t{0};
+    }
+
+    // Connected components of the free tiles. Built on first call after a change
+    // (O(cells)), then shared by copies until either side is modified. Labels are
+    // per index, so a maze that is not Indexed() has none.
+    // Not safe to call concurrently on the same Maze while it is being rebuilt.
+    const MazeComponents& Components() const;
+    // Installs labels built elsewhere for the current tiles (MazeComponentsBuilder),
+    // so Components() does not build them again.
+    void AdoptComponents(std::shared_ptr<const MazeComponents> comps) noexcept { m_components = std::move(comps); }
+
+    // 64-bit content hash of the size and the free/wall bits (RowFingerprint).
+    // Equal mazes hash equal regardless of how they were built, and equal to a
+    // MazeView of the same tiles; cached until the next change.
+    uint64_t Fingerprint() const noexcept;
+
+    // Storage actually in use: chunk table, allocated chunks and, once built,
+    // the component labels (shared by copies, counted by each).
+    size_t AllocatedChunks() const noexcept { return m_allocated; }
+    size_t MemoryBytes() const noexcept;
+
     // Move on the tile grid: adjacent step to a free tile.
     bool CanMove(CellPos from, Dir dir) const noexcept;
     CellPos Step(CellPos from, Dir dir) const noexcept;
@@ -32,9 +100,42 @@ public:
     void CarvePassage(CellPos aOdd, CellPos bOdd); // opens a, b and the middle tile
 
 private:
+    // One CellLayout tile, in padded coordinates (px = x + 1, py = y + 1).
+    struct Chunk {
+        uint64_t rows[CellLayout::kTileSide]{};        // free bits, bit (px & 63) of rows[py & 63]
+        uint8_t open[CellLayout::kTileCells / 2]{};    // OpenDirs nibbles by local index, two per byte
+
+        uint8_t Open(int local) const noexcept {
+            return static_cast<uint8_t>((open[local >> 1] >> ((local & 1) * 4)) & 0x0Fu);
+        }
+    };
+
+    size_t ChunkSlot(int px, int py) const noexcept {
+        return static_cast<size_t>(py >> CellLayout::kTileShift) * static_cast<size_t>(m_tileCols) +
+               static_cast<size_t>(px >> CellLayout::kTileShift);
+    }
+    const Chunk* FindChunk(int px, int py) const noexcept { return m_chunks[ChunkSlot(px, py)].get(); }
+    Chunk& TouchChunk(int px, int py);
+    uint64_t ChunkRow(int tileCol, int py) const noexcept;
+    uint64_t TailMask(int k) const noexcept;
+    void RebuildOpenDirs(Chunk& c, int tileCol, int tileRow) const noexcept;
+    void LoadChunkRow(const uint64_t* freeRows, size_t stride, int tileRow);
+    void RebuildChunkRow(int tileRow);
+    void OnFreeChanged(CellPos p, bool free);
+    void InvalidateDerived() noexcept;
+
     int m_w{0};
     int m_h{0};
-    std::vector<uint8_t> m_wall; // 1 = wall, 0 = free
+    int m_wordsPerRow{0};
+    int m_tileCols{0}; // chunk grid over the padded tiles, as CellLayout tiles them
+    int m_tileRows{0};
+    CellLayout m_layout; // empty unless both sides fit CellLayout::kMaxSide
+    std::vector<std::unique_ptr<Chunk>> m_chunks; // m_tileCols x m_tileRows, null = all wall
+    size_t m_allocated{0};
+    mutable std::shared_ptr<const MazeComponents> m_components; // null = stale
+    mutable uint64_t m_fingerprint{0}; // 0 = stale
 };
 
+static_assert(MazeGrid<Maze>);
+
 } // namespace ml
@@ -0,0 +1,160 @@
+#include "core/MazeComponents.h"
+#include "core/DisjointSet.h"
+#include "core/Maze.h"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <type_traits>
+
+namespace ml {
+
+void MazeComponents::Build(const Maze& maze) {
+    MazeComponentsBuilder builder(maze);
+    builder.Step(std::numeric_limits<long long>::max());
+    *this = std::move(*builder.Take());
+}
+
+MazeComponentsBuilder::MazeComponentsBuilder(const Maze& maze)
+    : m_maze(maze), m_out(std::make_shared<MazeComponents>()) {
+    m_out->m_layout = maze.Layout();
+    m_out->m_labels.reserve(static_cast<size_t>(m_out->m_layout.Count())); // filled with kNone by Clear
+    m_rowStart.assign(static_cast<size_t>(maze.Height()) + 1, 0);
+}
+
+float MazeComponentsBuilder::Progress() const noexcept {
+    const float h = static_cast<float>(std::max(1, m_maze.Height()));
+    switch (m_phase) {
+    case Phase::Clear: return 0.f;
+    case Phase::Runs: return 0.3f * static_cast<float>(m_y) / h;
+    case Phase::Merge: return 0.3f + 0.2f * static_cast<float>(m_y) / h;
+    case Phase::Number:
+        return 0.5f + 0.1f * static_cast<float>(m_next) / static_cast<float>(std::max<size_t>(1, m_runs.size()));
+    case Phase::Label: return 0.6f + 0.4f * static_cast<float>(m_y) / h;
+    case Phase::Done: break;
+    }
+    return 1.f;
+}
+
+bool MazeComponentsBuilder::Step(long long budget) {
+    // Scanline labelling: horizontal runs of free tiles come straight from the
+    // row words, runs overlapping the row above are merged with union-find,
+    // then every run writes its component label.
+    const Maze& maze = m_maze;
+    const int h = maze.Height();
+    const int words = maze.WordsPerRow();
+    MazeComponents& out = *m_out;
+
+    while (budget > 0 && m_phase != Phase::Done) {
+        switch (m_phase) {
+        case Phase::Clear: {
+            // a row word's worth of labels per unit, without reallocating
+            std::vector<int>& labels = out.m_labels;
+            const size_t count = static_cast<size_t>(out.m_layout.Count());
+            const size_t step = static_cast<size_t>(std::min<long long>(budget, 1 << 20)) * 64;
+            labels.resize(std::min(count, labels.size() + step), MazeComponents::kNone);
+            budget -= static_cast<long long>(step / 64);
+            if (labels.size() == count) m_phase = maze.Indexed() ? Phase::Runs : Phase::Done;
+            break;
+        }
+        case Phase::Runs: {
+            const int y = m_y++;
+            m_rowStart[static_cast<size_t>(y)] = m_runs.size();
+            const size_t first = m_runs.size();
+            for (int k = 0; k < words; ++k) {
+                uint64_t bits = maze.RowWord(y, k);
+                while (bits) {
+                    const int s = std::countr_zero(bits);
+                    const uint64_t rest = ~bits & (~uint64_t{0} << s);
+                    const int e = rest ? std::countr_zero(rest) : 64;
+                    const int x0 = k * 64 + s;
+                    if (s == 0 && m_runs.size() > first && m_runs.back().x1 == x0) m_runs.back().x1 = k * 64 + e;
+                    else m_runs.push_back({x0, k * 64 + e});
+                    bits = e == 64 ? 0u : bits & (~uint64_t{0} << e);
+                }
+            }
+            budget -= words;
+            if (m_y == h) {
+                m_rowStart[static_cast<size_t>(h)] = m_runs.size();
+                m_parent.resize(m_runs.size());
+                for (size_t i = 0; i < m_runs.size(); ++i) m_parent[i] = static_cast<int>(i);
+                m_phase = Phase::Merge;
+                m_y = 1;
+            }
+            break;
+        }
+        case Phase::Merge: {
+            if (m_y < h) {
+                const int y = m_y++;
+                size_t a = m_rowStart[static_cast<size_t>(y) - 1];
+                const size_t aEnd = m_rowStart[static_cast<size_t>(y)];
+                size_t b = aEnd;
+                const size_t bEnd = m_rowStart[static_cast<size_t>(y) + 1];
+                budget -= 1 + static_cast<long long>(bEnd - a);
+                while (a < aEnd && b < bEnd) {
+                    if (m_runs[a].x0 < m_runs[b].x1 && m_runs[b].x0 < m_runs[a].x1) {
+                        const int ra = FindRoot(m_parent, static_cast<int>(a));
+                        const int rb = FindRoot(m_parent, static_cast<int>(b));
+                        // keep the earlier run as root so labels follow scan order
+                        if (ra < rb) m_parent[static_cast<size_t>(rb)] = ra;
+                        else if (rb < ra) m_parent[static_cast<size_t>(ra)] = rb;
+                    }
+                    if (m_runs[a].x1 < m_runs[b].x1) ++a;
+                    else ++b;
+                }
+            }
+            if (m_y >= h) {
+                m_runLabel.resize(m_runs.size());
+                m_phase = Phase::Number;
+            }
+            break;
+        }
+        case Phase::Number: {
+            // roots are the smallest run of their set, so they are labelled before their members
+            const size_t end = std::min(m_runs.size(), m_next + static_cast<size_t>(std::min<long long>(budget, 1 << 20)));
+            for (size_t i = m_next; i < end; ++i) {
+                const int root = FindRoot(m_parent, static_cast<int>(i));
+                if (root == static_cast<int>(i)) {
+                    m_runLabel[i] = out.Count();
+                    out.m_sizes.push_back(0);
+                } else {
+                    m_runLabel[i] = m_runLabel[static_cast<size_t>(root)];
+                }
+                out.m_sizes[static_cast<size_t>(m_runLabel[i])] += m_runs[i].x1 - m_runs[i].x0;
+            }
+            budget -= 1 + static_cast<long long>(end - m_next);
+            m_next = end;
+            if (m_next == m_runs.size()) {
+                m_phase = Phase::Label;
+                m_y = 0;
+            }
+            break;
+        }
+        case Phase::Label: {
+            const int y = m_y++;
+            for (size_t i = m_rowStart[static_cast<size_t>(y)]; i < m_rowStart[static_cast<size_t>(y) + 1]; ++i) {
+                const int label = m_runLabel[i];
+                const Run& run = m_runs[i];
+                if constexpr (std::is_same_v<TileOrder, RowMajorTileOrder>) {
+                    // consecutive x are consecutive indices up to the tile edge
+                    for (int x = run.x0; x < run.x1;) {
+                        const int span = std::min(run.x1 - x, CellLayout::kTileSide - ((x + 1) & CellLayout::kTileMask));
+                        const auto dst = out.m_labels.begin() + out.m_layout.Index({x, y});
+                        std::fill(dst, dst + span, label);
+                        x += span;
+                    }
+                } else {
+                    for (int x = run.x0; x < run.x1; ++x) out.m_labels[static_cast<size_t>(out.m_layout.Index({x, y}))] = label;
+                }
+            }
+            budget -= words;
+            if (m_y == h) m_phase = Phase::Done;
+            break;
+        }
+        case Phase::Done:
+            break;
+        }
+    }
+    return m_phase == Phase::Done;
+}
+
+} // namespace ml
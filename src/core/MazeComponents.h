@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "core/Types.h"
+#include "core/CellLayout.h"
+
+namespace ml {
+
+class Maze;
+
+// 4-connected components of the free tiles, labelled once per maze revision.
+// Labels are stored by CellLayout index, so every query is a couple of loads.
+// Labels are numbered in row-major order of each component's first tile.
+class MazeComponents {
+public:
+    static constexpr int kNone = -1; // wall or out of bounds
+
+    void Build(const Maze& maze);
+
+    int Count() const noexcept { return static_cast<int>(m_sizes.size()); }
+
+    int LabelAt(int idx) const noexcept { return m_labels[static_cast<size_t>(idx)]; }
+    int Label(CellPos p) const noexcept {
+        return m_layout.InBounds(p) ? LabelAt(m_layout.Index(p)) : kNone;
+    }
+
+    bool Connected(CellPos a, CellPos b) const noexcept {
+        const int la = Label(a);
+        return la != kNone && la == Label(b);
+    }
+
+    // Number of tiles in p's component (0 for walls).
+    int ComponentSize(CellPos p) const noexcept {
+        const int l = Label(p);
+        return l == kNone ? 0 : m_sizes[static_cast<size_t>(l)];
+    }
+
+    // Label and size arrays.
+    size_t MemoryBytes() const noexcept {
+        return m_labels.capacity() * sizeof(int) + m_sizes.capacity() * sizeof(int);
+    }
+
+private:
+    friend class MazeComponentsBuilder;
+
+    CellLayout m_layout;
+    std::vector<int> m_labels; // by CellLayout index
+    std::vector<int> m_sizes;  // by label
+};
+
+// MazeComponents::Build in slices, for callers that must not block (the
+// cellular generator's task). The maze must stay alive and unchanged until
+// Step() has returned true.
+class MazeComponentsBuilder {
+public:
+    explicit MazeComponentsBuilder(const Maze& maze);
+
+    // Does about `budget` units of work (a row word or a run each); true once
+    // every tile is labelled.
+    bool Step(long long budget);
+    float Progress() const noexcept;
+
+    // The finished labels, once Step() has returned true.
+    std::shared_ptr<MazeComponents> Take() noexcept { return std::move(m_out); }
+
+private:
+    struct Run {
+        int x0; // first free tile
+        int x1; // one past the last
+    };
+    enum class Phase { Clear, Runs, Merge, Number, Label, Done };
+
+    const Maze& m_maze;
+    std::shared_ptr<MazeComponents> m_out;
+    Phase m_phase{Phase::Clear};
+    int m_y{0};        // next row (Runs, Merge, Label)
+    size_t m_next{0};  // next run (Number)
+    std::vector<Run> m_runs;
+    std::vector<size_t> m_rowStart; // first run of each row, plus the end
+    std::vector<int> m_parent;      // union-find over runs
+    std::vector<int> m_runLabel;
+};
+
+} // namespace ml
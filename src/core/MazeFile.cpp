@@ -0,0 +1,196 @@
+#include "core/MazeFile.h"
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ml {
+
+static constexpr char kMagic[4] = {'M', 'L', 'Z', 'B'};
+
+bool MazeFileWriter::Open(const std::string& path, int width, int height, const MazeMeta& meta) {
+    m_out.close();
+    m_out.clear();
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out) return false;
+
+    m_height = height;
+    m_wordsPerRow = (width + 63) / 64;
+    m_rowsWritten = 0;
+
+    MazeFileHeader hdr{};
+    std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+    hdr.version = kMazeFileVersion;
+    hdr.width = static_cast<uint32_t>(width);
+    hdr.height = static_cast<uint32_t>(height);
+    hdr.startX = meta.start.x;
+    hdr.startY = meta.start.y;
+    hdr.exitX = meta.exit.x;
+    hdr.exitY = meta.exit.y;
+    hdr.generator = meta.generator;
+    hdr.wordsPerRow = static_cast<uint32_t>(m_wordsPerRow);
+    hdr.seed = meta.seed;
+    m_out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    return static_cast<bool>(m_out);
+}
+
+bool MazeFileWriter::WriteRow(const uint64_t* freeWords) {
+    if (m_rowsWritten >= m_height) return false;
+    m_out.write(reinterpret_cast<const char*>(freeWords), static_cast<std::streamsize>(m_wordsPerRow * sizeof(uint64_t)));
+    ++m_rowsWritten;
+    return static_cast<bool>(m_out);
+}
+
+bool MazeFileWriter::Close() {
+    const bool ok = m_out.is_open() && m_rowsWritten == m_height && m_out.flush();
+    m_out.close();
+    return ok;
+}
+
+bool SaveMazeBinary(const std::string& path, const Maze& maze, const MazeMeta& meta) {
+    MazeFileWriter writer;
+    if (!writer.Open(path, maze.Width(), maze.Height(), meta)) return false;
+
+    std::vector<uint64_t> row(static_cast<size_t>(maze.WordsPerRow()));
+    for (int y = 0; y < maze.Height(); ++y) {
+        for (int k = 0; k < maze.WordsPerRow(); ++k) row[static_cast<size_t>(k)] = maze.RowWord(y, k);
+        if (!writer.WriteRow(row.data())) return false;
+    }
+    return writer.Close();
+}
+
+MazeView::~MazeView() { Close(); }
+
+MazeView::MazeView(MazeView&& o) noexcept { *this = std::move(o); }
+
+MazeView& MazeView::operator=(MazeView&& o) noexcept {
+    if (this != &o) {
+        Close();
+        m_base = std::exchange(o.m_base, nullptr);
+        m_size = std::exchange(o.m_size, 0);
+#ifdef _WIN32
+        m_file = std::exchange(o.m_file, nullptr);
+        m_mapping = std::exchange(o.m_mapping, nullptr);
+#endif
+        m_rows = std::exchange(o.m_rows, nullptr);
+        m_w = std::exchange(o.m_w, 0);
+        m_h = std::exchange(o.m_h, 0);
+        m_wordsPerRow = std::exchange(o.m_wordsPerRow, 0);
+        m_layout = std::exchange(o.m_layout, CellLayout());
+        m_fingerprint = std::exchange(o.m_fingerprint, 0);
+        m_meta = o.m_meta;
+    }
+    return *this;
+}
+
+bool MazeView::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(MazeFileHeader))) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!base) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_base = base;
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(MazeFileHeader))) {
+        ::close(fd);
+        return false;
+    }
+    void* base = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file referenced
+    if (base == MAP_FAILED) return false;
+    m_base = base;
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    const auto* hdr = static_cast<const MazeFileHeader*>(m_base);
+    const uint64_t w = hdr->width;
+    const uint64_t h = hdr->height;
+    const bool valid = std::memcmp(hdr->magic, kMagic, sizeof(kMagic)) == 0 &&
+                       hdr->version == kMazeFileVersion &&
+                       w >= 3 && h >= 3 && w <= 0x7fffffffu && h <= 0x7fffffffu &&
+                       hdr->wordsPerRow == (w + 63) / 64 &&
+                       m_size >= sizeof(MazeFileHeader) + h * hdr->wordsPerRow * sizeof(uint64_t);
+    if (!valid) {
+        Close();
+        return false;
+    }
+
+    m_w = static_cast<int>(w);
+    m_h = static_cast<int>(h);
+    m_wordsPerRow = static_cast<int>(hdr->wordsPerRow);
+    m_rows = reinterpret_cast<const uint64_t*>(static_cast<const char*>(m_base) + sizeof(MazeFileHeader));
+    if (m_w <= CellLayout::kMaxSide && m_h <= CellLayout::kMaxSide) m_layout.Reset(m_w, m_h);
+    m_meta.start = {hdr->startX, hdr->startY};
+    m_meta.exit = {hdr->exitX, hdr->exitY};
+    m_meta.generator = hdr->generator;
+    m_meta.seed = hdr->seed;
+    return true;
+}
+
+void MazeView::Close() {
+#ifdef _WIN32
+    if (m_base) UnmapViewOfFile(m_base);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_base) ::munmap(m_base, m_size);
+#endif
+    m_base = nullptr;
+    m_size = 0;
+    m_rows = nullptr;
+    m_w = m_h = m_wordsPerRow = 0;
+    m_layout = CellLayout();
+    m_fingerprint = 0;
+    m_meta = MazeMeta{};
+}
+
+uint64_t MazeView::Fingerprint() const noexcept {
+    if (!m_fingerprint) m_fingerprint = RowFingerprint(*this);
+    return m_fingerprint;
+}
+
+bool MazeView::CopyTo(Maze& out) const {
+    if (m_w > Maze::kMaxSide || m_h > Maze::kMaxSide) return false;
+    out.Resize(m_w, m_h);
+    out.LoadRows(m_rows, static_cast<size_t>(m_wordsPerRow));
+    return true;
+}
+
+} // namespace ml
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "core/Maze.h"
+
+namespace ml {
+
+// Binary maze format (.mlzb), little-endian:
+//   MazeFileHeader (64 bytes)
+//   height rows x wordsPerRow uint64 words, same bit layout as Maze::RowWord
+//   (bit i of word k = tile (k*64 + i, y), 1 = free, bits past the width are 0).
+// The header size keeps the rows 8-byte aligned inside a mapping.
+inline constexpr uint32_t kMazeFileVersion = 1;
+
+struct MazeFileHeader {
+    char magic[4];        // "MLZB"
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    int32_t startX, startY;
+    int32_t exitX, exitY;
+    uint32_t generator;   // SimConfig::generatorIndex
+    uint32_t wordsPerRow;
+    uint64_t seed;
+    uint64_t reserved[2];
+};
+static_assert(sizeof(MazeFileHeader) == 64, "MazeFileHeader must stay 64 bytes");
+
+struct MazeMeta {
+    CellPos start{1,1};
+    CellPos exit{1,1};
+    uint32_t generator{0};
+    uint64_t seed{0};
+};
+
+bool SaveMazeBinary(const std::string& path, const Maze& maze, const MazeMeta& meta);
+
+// Writes an .mlzb file one row at a time, for mazes produced as a stream
+// (EllerGenerator::Stream) that never exist in memory as a whole.
+class MazeFileWriter {
+public:
+    bool Open(const std::string& path, int width, int height, const MazeMeta& meta);
+    // WordsPerRow() words in the RowWord layout; bits past the width must be 0.
+    bool WriteRow(const uint64_t* freeWords);
+    // False if a write failed or fewer than height rows were written.
+    bool Close();
+
+    int WordsPerRow() const noexcept { return m_wordsPerRow; }
+    int RowsWritten() const noexcept { return m_rowsWritten; }
+
+private:
+    std::ofstream m_out;
+    int m_height{0};
+    int m_wordsPerRow{0};
+    int m_rowsWritten{0};
+};
+
+// Read-only maze backed by a memory-mapped .mlzb file. It is a MazeGrid, so the
+// pathfinders and FindPaths query the mapped rows directly (no copy); several
+// processes mapping the same file share one page-cache copy. Open directions
+// are worked out from the bits on each query, a little slower per step than
+// Maze's stored masks. CopyTo() gives a mutable Maze when one is needed.
+class MazeView {
+public:
+    MazeView() = default;
+    ~MazeView();
+    MazeView(const MazeView&) = delete;
+    MazeView& operator=(const MazeView&) = delete;
+    MazeView(MazeView&& o) noexcept;
+    MazeView& operator=(MazeView&& o) noexcept;
+
+    bool Open(const std::string& path); // false if missing or not a valid .mlzb
+    void Close();
+    bool IsOpen() const noexcept { return m_rows != nullptr; }
+
+    const MazeMeta& Meta() const noexcept { return m_meta; }
+    int Width() const noexcept { return m_w; }
+    int Height() const noexcept { return m_h; }
+
+    bool InBounds(CellPos p) const noexcept {
+        return p.x >= 0 && p.y >= 0 && p.x < m_w && p.y < m_h;
+    }
+    bool IsWall(CellPos p) const noexcept {
+        if (!InBounds(p)) return true;
+        return ((m_rows[static_cast<size_t>(p.y) * m_wordsPerRow + static_cast<size_t>(p.x >> 6)] >> (p.x & 63)) & 1u) == 0;
+    }
+    bool IsFree(CellPos p) const noexcept { return !IsWall(p); }
+
+    // Computed from the bits (the file has no nibbles).
+    uint8_t OpenDirs(CellPos p) const noexcept {
+        return static_cast<uint8_t>(IsFree({p.x, p.y - 1}) << static_cast<int>(Dir::N) |
+                                    IsFree({p.x + 1, p.y}) << static_cast<int>(Dir::E) |
+                                    IsFree({p.x, p.y + 1}) << static_cast<int>(Dir::S) |
+                                    IsFree({p.x - 1, p.y}) << static_cast<int>(Dir::W));
+    }
+    bool CanMove(CellPos from, Dir dir) const noexcept { return (OpenDirs(from) & DirBit(dir)) != 0; }
+    CellPos Step(CellPos from, Dir dir) const noexcept {
+        const auto d = Delta(dir);
+        return {from.x + d.dx, from.y + d.dy};
+    }
+
+    int WordsPerRow() const noexcept { return m_wordsPerRow; }
+    uint64_t RowWord(int y, int k) const noexcept {
+        if (y < 0 || y >= m_h || k < 0 || k >= m_wordsPerRow) return 0u;
+        return m_rows[static_cast<size_t>(y) * m_wordsPerRow + static_cast<size_t>(k)];
+    }
+
+    // Index-based access with Maze's layout, so per-maze caches keyed by
+    // Fingerprint() fit either. Only for sides up to CellLayout::kMaxSide.
+    bool Indexed() const noexcept { return m_layout.Count() != 0; }
+    const CellLayout& Layout() const noexcept { return m_layout; }
+    uint8_t OpenDirsAt(int idx) const noexcept { return OpenDirs(m_layout.Pos(idx)); }
+
+    // Same value as Maze::Fingerprint() of a copy; computed on first call.
+    uint64_t Fingerprint() const noexcept;
+
+    // Materialize into a mutable Maze. False (out untouched) if a side exceeds
+    // Maze::kMaxSide; the view itself reads any size.
+    bool CopyTo(Maze& out) const;
+
+private:
+    void* m_base{nullptr};
+    size_t m_size{0};
+#ifdef _WIN32
+    void* m_file{nullptr};
+    void* m_mapping{nullptr};
+#endif
+    const uint64_t* m_rows{nullptr};
+    int m_w{0};
+    int m_h{0};
+    int m_wordsPerRow{0};
+    CellLayout m_layout;
+    mutable uint64_t m_fingerprint{0}; // 0 = not computed
+    MazeMeta m_meta;
+};
+
+static_assert(MazeGrid<MazeView>);
+
+} // namespace ml
@@ -0,0 +1,47 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include "core/CellLayout.h"
+#include "core/Types.h"
+
+namespace ml {
+
+// Read-only tile queries shared by Maze and MazeView (a mapped .mlzb file).
+// The searches are written against this, so they run on either without a
+// copy. Index-based access follows CellLayout and needs Indexed().
+template <class G>
+concept MazeGrid = requires(const G& g, CellPos p, int idx, int y, int k) {
+    { g.Width() } -> std::same_as<int>;
+    { g.Height() } -> std::same_as<int>;
+    { g.InBounds(p) } -> std::same_as<bool>;
+    { g.IsWall(p) } -> std::same_as<bool>;
+    { g.IsFree(p) } -> std::same_as<bool>;
+    { g.OpenDirs(p) } -> std::same_as<uint8_t>;
+    { g.WordsPerRow() } -> std::same_as<int>;
+    { g.RowWord(y, k) } -> std::same_as<uint64_t>;
+    { g.Indexed() } -> std::same_as<bool>;
+    { g.Layout() } -> std::same_as<const CellLayout&>;
+    { g.OpenDirsAt(idx) } -> std::same_as<uint8_t>;
+    { g.Fingerprint() } -> std::same_as<uint64_t>;
+};
+
+// FNV-1a over the size and the row words, so equal tiles hash equal whatever
+// holds them (never 0, which callers use for "not computed").
+template <class G>
+uint64_t RowFingerprint(const G& g) noexcept {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t v) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (v >> (i * 8)) & 0xFFu;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(static_cast<uint64_t>(g.Width()));
+    mix(static_cast<uint64_t>(g.Height()));
+    for (int y = 0; y < g.Height(); ++y) {
+        for (int k = 0; k < g.WordsPerRow(); ++k) mix(g.RowWord(y, k));
+    }
+    return hash ? hash : 1u;
+}
+
+} // namespace ml
@@ -0,0 +1,20 @@
+#include "core/MazePool.h"
+#include <algorithm>
+
+namespace ml {
+
+void MazePool::Reset(int width, int height, int count) {
+    m_w = std::max(3, width);
+    m_h = std::max(3, height);
+    m_count = std::max(0, count);
+    m_wordsPerRow = (m_w + 63) / 64;
+    m_words.assign(MazeWords() * static_cast<size_t>(m_count), 0u);
+    m_seeds.assign(static_cast<size_t>(m_count), 0u);
+}
+
+void MazePool::CopyTo(int i, Maze& out) const {
+    out.Resize(m_w, m_h);
+    out.LoadRows(Rows(i), static_cast<size_t>(m_wordsPerRow));
+}
+
+} // namespace ml
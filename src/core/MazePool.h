@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/Maze.h"
+
+namespace ml {
+
+// Same-sized mazes stored back to back as bit-packed rows (Maze::RowWord
+// layout, 1 = free) in one allocation. Filled by GenerateBatch; an entry
+// becomes a regular Maze through CopyTo when it is actually needed.
+class MazePool {
+public:
+    // Sizes the pool for count mazes of width x height (sides >= 3, like
+    // Maze::Resize) and clears every entry to walls.
+    void Reset(int width, int height, int count);
+
+    int Width() const noexcept { return m_w; }
+    int Height() const noexcept { return m_h; }
+    int Count() const noexcept { return m_count; }
+    int WordsPerRow() const noexcept { return m_wordsPerRow; }
+    size_t MazeWords() const noexcept { return static_cast<size_t>(m_h) * static_cast<size_t>(m_wordsPerRow); }
+
+    uint64_t* Rows(int i) noexcept { return m_words.data() + static_cast<size_t>(i) * MazeWords(); }
+    const uint64_t* Rows(int i) const noexcept { return m_words.data() + static_cast<size_t>(i) * MazeWords(); }
+
+    uint32_t Seed(int i) const noexcept { return m_seeds[static_cast<size_t>(i)]; }
+    void SetSeed(int i, uint32_t seed) noexcept { m_seeds[static_cast<size_t>(i)] = seed; }
+
+    bool IsFree(int i, CellPos p) const noexcept {
+        if (p.x < 0 || p.y < 0 || p.x >= m_w || p.y >= m_h) return false;
+        const uint64_t word = Rows(i)[static_cast<size_t>(p.y) * static_cast<size_t>(m_wordsPerRow) + static_cast<size_t>(p.x >> 6)];
+        return (word >> (p.x & 63)) & 1u;
+    }
+
+    void CopyTo(int i, Maze& out) const;
+
+    size_t MemoryBytes() const noexcept { return m_words.capacity() * sizeof(uint64_t) + m_seeds.capacity() * sizeof(uint32_t); }
+
+private:
+    int m_w{0};
+    int m_h{0};
+    int m_count{0};
+    int m_wordsPerRow{0};
+    std::vector<uint64_t> m_words;
+    std::vector<uint32_t> m_seeds;
+};
+
+} // namespace ml
@@ -1,17 +1,143 @@
 #include "core/RNG.h"
+#include <random>
 
 namespace ml {
 
-RNG::RNG() : m_rng(std::random_device{}()) {}
-RNG::RNG(uint32_t seed) : m_rng(seed) {}
+static uint64_t SplitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+RNG::RNG() {
+    std::random_device rd;
+    Seed((uint64_t{rd()} << 32) | rd());
+}
+
+RNG::RNG(uint64_t seed, uint64_t stream) { Seed(seed, stream); }
+
+void RNG::Seed(uint64_t seed, uint64_t stream) {
+    m_seed = seed;
+    m_stream = stream;
+    const uint64_t k = SplitMix64(seed);
+    m_key[0] = static_cast<uint32_t>(k);
+    m_key[1] = static_cast<uint32_t>(k >> 32);
+    m_pos = 0;
+    m_block = ~uint64_t{0};
+}
+
+RNG RNG::Split(uint64_t streamId) const {
+    return RNG(m_seed, SplitMix64(m_stream ^ SplitMix64(streamId)));
+}
+
+void RNG::PhiloxBlock(uint64_t block, uint32_t out[4]) const noexcept {
+    // counter = (block, stream), 10 Philox rounds
+    uint32_t c0 = static_cast<uint32_t>(block);
+    uint32_t c1 = static_cast<uint32_t>(block >> 32);
+    uint32_t c2 = static_cast<uint32_t>(m_stream);
+    uint32_t c3 = static_cast<uint32_t>(m_stream >> 32);
+    uint32_t k0 = m_key[0];
+    uint32_t k1 = m_key[1];
+    for (int round = 0; round < 10; ++round) {
+        const uint64_t p0 = uint64_t{0xD2511F53u} * c0;
+        const uint64_t p1 = uint64_t{0xCD9E8D57u} * c2;
+        const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        const uint32_t n1 = static_cast<uint32_t>(p1);
+        const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        const uint32_t n3 = static_cast<uint32_t>(p0);
+        c0 = n0; c1 = n1; c2 = n2; c3 = n3;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
 
-void RNG::Seed(uint32_t seed) { m_rng.seed(seed); }
+void RNG::FillBlock(uint64_t block) {
+    PhiloxBlock(block, m_out);
+    m_block = block;
+}
 
-uint32_t RNG::NextU32() { return static_cast<uint32_t>(m_rng()); }
+uint32_t RNG::NextU32() {
+    const uint64_t block = m_pos >> 2;
+    if (block != m_block) FillBlock(block);
+    return m_out[m_pos++ & 3u];
+}
+
+uint64_t RNG::NextU64() {
+    const uint64_t lo = NextU32();
+    return lo | (uint64_t{NextU32()} << 32);
+}
+
+void RNG::FillU64(uint64_t* out, size_t n) {
+    size_t i = 0;
+    while (i < n && (m_pos & 3u) != 0) out[i++] = NextU64();
+    // Block-aligned: each block is two outputs, no buffering. Eight blocks run
+    // side by side so the rounds vectorize / overlap their multiplies.
+    constexpr int kLanes = 8;
+    for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+        uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+        const uint64_t block = m_pos >> 2;
+        for (int l = 0; l < kLanes; ++l) {
+            c0[l] = static_cast<uint32_t>(block + static_cast<uint64_t>(l));
+            c1[l] = static_cast<uint32_t>((block + static_cast<uint64_t>(l)) >> 32);
+            c2[l] = static_cast<uint32_t>(m_stream);
+            c3[l] = static_cast<uint32_t>(m_stream >> 32);
+        }
+        uint32_t k0 = m_key[0];
+        uint32_t k1 = m_key[1];
+        for (int round = 0; round < 10; ++round) {
+            for (int l = 0; l < kLanes; ++l) {
+                const uint64_t p0 = uint64_t{0xD2511F53u} * c0[l];
+                const uint64_t p1 = uint64_t{0xCD9E8D57u} * c2[l];
+                const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+                const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+                c1[l] = static_cast<uint32_t>(p1);
+                c3[l] = static_cast<uint32_t>(p0);
+                c0[l] = n0;
+                c2[l] = n2;
+            }
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (int l = 0; l < kLanes; ++l) {
+            out[i + 2 * l] = c0[l] | (uint64_t{c1[l]} << 32);
+            out[i + 2 * l + 1] = c2[l] | (uint64_t{c3[l]} << 32);
+        }
+        m_pos += 4 * kLanes;
+    }
+    uint32_t b[4];
+    for (; i + 2 <= n; i += 2) {
+        PhiloxBlock(m_pos >> 2, b);
+        out[i] = b[0] | (uint64_t{b[1]} << 32);
+        out[i + 1] = b[2] | (uint64_t{b[3]} << 32);
+        m_pos += 4;
+    }
+    for (; i < n; ++i) out[i] = NextU64();
+}
+
+uint32_t RNG::NextBelow(uint32_t bound) {
+    // Lemire: the high word of x * bound is uniform once the low word clears the threshold
+    uint64_t m = uint64_t{NextU32()} * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < bound) {
+        const uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+        while (low < threshold) {
+            m = uint64_t{NextU32()} * bound;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
 
 int RNG::NextInt(int lo, int hiInclusive) {
-    std::uniform_int_distribution<int> dist(lo, hiInclusive);
-    return dist(m_rng);
+    if (hiInclusive <= lo) return lo;
+    const uint32_t span = static_cast<uint32_t>(static_cast<int64_t>(hiInclusive) - lo + 1); // 0 = full 2^32
+    const uint32_t r = span ? NextBelow(span) : NextU32();
+    return static_cast<int>(static_cast<int64_t>(lo) + r);
 }
 
 } // namespace ml
@@ -1,25 +1,61 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
-#include <random>
+#include <iterator>
+#include <utility>
 
 namespace ml {
 
+// Counter-based generator (Philox4x32-10). Output i of a stream is a pure
+// function of (seed, stream, i), so the state is just those numbers plus a
+// four-word output block: Jump() is O(1) and Split() hands out independent,
+// reproducible streams (one per worker/tile) derived from a single seed.
 class RNG {
 public:
-    RNG();
-    explicit RNG(uint32_t seed);
+    RNG(); // seeded from std::random_device
+    explicit RNG(uint64_t seed, uint64_t stream = 0);
+
+    void Seed(uint64_t seed, uint64_t stream = 0);
 
-    void Seed(uint32_t seed);
     uint32_t NextU32();
+    uint64_t NextU64();
+    // Same values as n NextU64() calls, produced a whole block at a time.
+    void FillU64(uint64_t* out, size_t n);
+
+    // Uniform in [0, bound) by multiply-shift with rejection (unbiased).
+    // bound == 0 returns 0.
+    uint32_t NextBelow(uint32_t bound);
     int NextInt(int lo, int hiInclusive);
 
+    // Skip the next n NextU32() outputs.
+    void Jump(uint64_t n) { m_pos += n; }
+    uint64_t Position() const noexcept { return m_pos; }
+
+    // Independent stream for streamId, derived from this generator's seed and
+    // stream (not its position). Same inputs, same stream, on any thread.
+    RNG Split(uint64_t streamId) const;
+
+    // Fisher-Yates with NextBelow, so the result only depends on the stream.
     template <class It>
     void Shuffle(It begin, It end) {
-        std::shuffle(begin, end, m_rng);
+        const auto n = std::distance(begin, end);
+        for (auto i = n - 1; i > 0; --i) {
+            const auto j = static_cast<decltype(i)>(NextBelow(static_cast<uint32_t>(i + 1)));
+            using std::swap;
+            swap(begin[i], begin[j]);
+        }
     }
 
 private:
-    std::mt19937 m_rng;
+    void FillBlock(uint64_t block);
+    void PhiloxBlock(uint64_t block, uint32_t out[4]) const noexcept;
+
+    uint32_t m_key[2]{};
+    uint64_t m_seed{0};
+    uint64_t m_stream{0};
+    uint64_t m_pos{0};                  // NextU32 outputs consumed
+    uint64_t m_block{~uint64_t{0}};     // block held in m_out
+    uint32_t m_out[4]{};
 };
 
 } // namespace ml
@@ -0,0 +1,90 @@
+#include "core/ThreadPool.h"
+#include <algorithm>
+
+namespace ml {
+
+// Set on pool workers and on a caller while it runs loop bodies.
+static thread_local bool t_inLoop = false;
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    m_workers.reserve(static_cast<size_t>(threads - 1));
+    for (int slot = 1; slot < threads; ++slot) {
+        m_workers.emplace_back([this, slot] { WorkerLoop(slot); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_workers) t.join();
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int, int)>& fn, int maxThreads) {
+    if (count <= 0) return;
+
+    int threads = Size();
+    if (maxThreads > 0) threads = std::min(threads, maxThreads);
+    threads = std::min(threads, count);
+
+    if (threads <= 1 || t_inLoop) {
+        for (int i = 0; i < count; ++i) fn(i, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> loop(m_loopMutex);
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_fn = &fn;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_slots = threads - 1;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    t_inLoop = true;
+    RunIndices(0);
+    t_inLoop = false;
+
+    // Workers that wake after this see m_slots == 0 and keep sleeping.
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_done.wait(lk, [&] { return m_busy == 0; });
+    m_slots = 0;
+    m_fn = nullptr;
+}
+
+void ThreadPool::RunIndices(int slot) {
+    for (int i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+         i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+        (*m_fn)(i, slot);
+    }
+}
+
+void ThreadPool::WorkerLoop(int slot) {
+    t_inLoop = true;
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lk(m_mutex);
+    for (;;) {
+        m_wake.wait(lk, [&] { return m_stop || (m_generation != seen && slot <= m_slots); });
+        if (m_stop) return;
+        seen = m_generation;
+        ++m_busy;
+        lk.unlock();
+
+        RunIndices(slot);
+
+        lk.lock();
+        if (--m_busy == 0) m_done.notify_all();
+    }
+}
+
+} // namespace ml
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ml {
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part in every loop, so a pool of size 1 has no workers at all.
+class ThreadPool {
+public:
+    // threads <= 0 uses std::thread::hardware_concurrency().
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads that run loop bodies, including the caller.
+    int Size() const noexcept { return static_cast<int>(m_workers.size()) + 1; }
+
+    // Calls fn(index, slot) for every index in [0, count), blocking until all
+    // are done. Indices are handed out dynamically; slot in [0, Size()) names
+    // the executing thread (for per-thread scratch). maxThreads > 0 caps the
+    // threads used. Calls made from a body running in parallel run inline.
+    void ParallelFor(int count, const std::function<void(int index, int slot)>& fn, int maxThreads = 0);
+
+    // Process-wide pool sized to the hardware.
+    static ThreadPool& Shared();
+
+private:
+    void WorkerLoop(int slot);
+    void RunIndices(int slot);
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::mutex m_loopMutex; // one loop at a time
+
+    // Current loop; published under m_mutex, indices claimed from m_next.
+    const std::function<void(int, int)>* m_fn{nullptr};
+    int m_count{0};
+    std::atomic<int> m_next{0};
+    int m_slots{0};     // workers allowed to join this loop
+    int m_busy{0};      // workers inside the current loop
+    uint64_t m_generation{0};
+    bool m_stop{false};
+};
+
+} // namespace ml
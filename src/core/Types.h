@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <cstdlib>
 #include <string>
 
 namespace ml {
@@ -12,6 +13,10 @@ struct CellPos {
     bool operator!=(const CellPos& o) const noexcept { return !(*this == o); }
 };
 
+// 4-connected grid distance; the admissible heuristic for every unit-cost search here.
+inline int Manhattan(CellPos a, CellPos b) { return std::abs(a.x - b.x) + std::abs(a.y - b.y); }
+
+// Plain row-major index for local scratch arrays; shared per-cell arrays use CellLayout.
 inline int ToIndex(int x, int y, int w) { return y * w + x; }
 
 enum class AgentStatus : uint8_t { Running, Success, Fail };
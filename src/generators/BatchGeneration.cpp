@@ -0,0 +1,34 @@
+#include "generators/BatchGeneration.h"
+#include "core/ThreadPool.h"
+#include <chrono>
+
+namespace ml {
+
+BatchStats GenerateBatch(IMazeGenerator& generator, const MazeGenConfig& cfg,
+                         const std::vector<uint32_t>& seeds, MazePool& outPool) {
+    const auto t0 = std::chrono::steady_clock::now();
+
+    const int count = static_cast<int>(seeds.size());
+    outPool.Reset(cfg.width, cfg.height, count);
+    const size_t stride = static_cast<size_t>(outPool.WordsPerRow());
+
+    ThreadPool& pool = ThreadPool::Shared();
+    std::vector<GenScratch> scratch(static_cast<size_t>(pool.Size()));
+    pool.ParallelFor(count, [&](int i, int slot) {
+        MazeGenConfig one = cfg;
+        one.seed = seeds[static_cast<size_t>(i)];
+        one.randomSeed = false;
+        outPool.SetSeed(i, one.seed);
+        generator.GenerateRows(one, outPool.Rows(i), stride, scratch[static_cast<size_t>(slot)]);
+    }, cfg.threads);
+
+    const auto t1 = std::chrono::steady_clock::now();
+    BatchStats stats;
+    stats.generator = generator.Name();
+    stats.mazes = count;
+    stats.cells = static_cast<uint64_t>(outPool.Width()) * static_cast<uint64_t>(outPool.Height()) * static_cast<uint64_t>(count);
+    stats.seconds = std::chrono::duration<double>(t1 - t0).count();
+    return stats;
+}
+
+} // namespace ml
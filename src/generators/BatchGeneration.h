@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/MazePool.h"
+#include "generators/IMazeGenerator.h"
+
+namespace ml {
+
+struct BatchStats {
+    std::string generator;
+    int mazes{0};
+    uint64_t cells{0}; // tiles over all mazes
+    double seconds{0.0};
+
+    double MazesPerSecond() const noexcept { return seconds > 0.0 ? mazes / seconds : 0.0; }
+    double CellsPerSecond() const noexcept { return seconds > 0.0 ? static_cast<double>(cells) / seconds : 0.0; }
+};
+
+// Generates one maze per seed (cfg with seed = seeds[i], never randomSeed)
+// into outPool, which is reset to cfg's size. Mazes are spread over the shared
+// ThreadPool (at most cfg.threads workers); each worker keeps one GenScratch
+// for all of its mazes. Entry i depends only on cfg and seeds[i].
+BatchStats GenerateBatch(IMazeGenerator& generator, const MazeGenConfig& cfg,
+                         const std::vector<uint32_t>& seeds, MazePool& outPool);
+
+} // namespace ml
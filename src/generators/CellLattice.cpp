@@ -0,0 +1,160 @@
+#include "generators/CellLattice.h"
+#include <algorithm>
+
+namespace ml {
+
+// Spreads the 32 bits of x to the even bit positions of a 64-bit word.
+static uint64_t SpreadBits(uint64_t x) {
+    x &= 0xFFFFFFFFull;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2))  & 0x3333333333333333ull;
+    x = (x | (x << 1))  & 0x5555555555555555ull;
+    return x;
+}
+
+void CellLattice::Reset(int cols, int rows) {
+    m_cols = std::max(0, cols);
+    m_rows = std::max(0, rows);
+    m_pitch = (m_cols + 1 + 63) & ~63;
+
+    const size_t rowWords = static_cast<size_t>(m_pitch) >> 6;
+    const size_t words = rowWords * static_cast<size_t>(m_rows + 2);
+    m_visited.assign(words, 0u);
+    m_east.assign(words, 0u);
+    m_south.assign(words, 0u);
+    m_parent.assign(words * 2, 0u);
+
+    // sentinels: padding rows above and below, padding columns at i >= cols
+    std::fill(m_visited.begin(), m_visited.begin() + static_cast<std::ptrdiff_t>(rowWords), ~uint64_t{0});
+    std::fill(m_visited.end() - static_cast<std::ptrdiff_t>(rowWords), m_visited.end(), ~uint64_t{0});
+    for (int j = 0; j < m_rows; ++j) {
+        uint64_t* row = m_visited.data() + static_cast<size_t>(j + 1) * rowWords;
+        for (size_t q = 0; q < rowWords; ++q) {
+            const int lo = static_cast<int>(q) * 64;
+            if (lo >= m_cols) row[q] = ~uint64_t{0};
+            else if (m_cols - lo < 64) row[q] = ~((uint64_t{1} << (m_cols - lo)) - 1u);
+        }
+    }
+}
+
+int CellLattice::UnvisitedDirs(int n, int outDirs[4]) const noexcept {
+    int count = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (!Visited(Step(n, d))) outDirs[count++] = d;
+    }
+    return count;
+}
+
+void CellLattice::Carve(int n, int d) noexcept {
+    switch (d) {
+    case 0: n -= m_pitch; [[fallthrough]];
+    case 2: m_south[Word(n)] |= uint64_t{1} << (n & 63); break;
+    case 3: n -= 1; [[fallthrough]];
+    default: m_east[Word(n)] |= uint64_t{1} << (n & 63); break;
+    }
+}
+
+void CellLattice::BeginCarve(LatticeCarver carver, int startNode) {
+    m_carver = carver;
+    m_startNode = startNode;
+    m_carved = 0;
+    m_frontier.clear();
+    if (NodeCount() == 0) {
+        m_cur = -1;
+        return;
+    }
+
+    m_cur = startNode;
+    Visit(startNode);
+    if (carver == LatticeCarver::Prim) PushFrontier(startNode);
+}
+
+void CellLattice::PushFrontier(int n) {
+    for (int d = 0; d < 4; ++d) {
+        const int m = Step(n, d);
+        if (!Visited(m)) m_frontier.push_back((static_cast<uint32_t>(m) << 2) | static_cast<uint32_t>(d));
+    }
+}
+
+bool CellLattice::CarveSome(RNG& rng, long long budget) {
+    if (m_cur < 0) return true;
+    const bool done = m_carver == LatticeCarver::Backtracker ? BacktrackerSome(rng, budget) : PrimSome(rng, budget);
+    if (done) m_cur = -1;
+    return done;
+}
+
+bool CellLattice::BacktrackerSome(RNG& rng, long long budget) {
+    int cur = m_cur;
+    int dirs[4];
+    for (; budget > 0; --budget) {
+        const int count = UnvisitedDirs(cur, dirs);
+        if (count == 0) {
+            if (cur == m_startNode) return true;
+            const int n = cur;
+            cur = Step(cur, static_cast<int>((m_parent[static_cast<size_t>(n) >> 5] >> ((n & 31) * 2)) & 3u));
+            continue;
+        }
+        const int d = dirs[count > 1 ? rng.NextBelow(static_cast<uint32_t>(count)) : 0];
+        const int next = Step(cur, d);
+        Carve(cur, d);
+        Visit(next);
+        m_parent[static_cast<size_t>(next) >> 5] |= static_cast<uint64_t>((d + 2) & 3) << ((next & 31) * 2);
+        cur = next;
+    }
+    m_cur = cur;
+    return false;
+}
+
+bool CellLattice::PrimSome(RNG& rng, long long budget) {
+    for (; budget > 0; --budget) {
+        if (m_frontier.empty()) return true;
+        const size_t size = m_frontier.size();
+        const size_t idx = size > 1 ? rng.NextBelow(static_cast<uint32_t>(size)) : 0;
+        const uint32_t e = m_frontier[idx];
+        m_frontier[idx] = m_frontier.back();
+        m_frontier.pop_back();
+
+        const int to = static_cast<int>(e >> 2);
+        if (Visited(to)) continue;
+        const int d = static_cast<int>(e & 3u);
+        Carve(Step(to, (d + 2) & 3), d);
+        Visit(to);
+        PushFrontier(to);
+    }
+    return m_frontier.empty();
+}
+
+void CellLattice::RasterizeRows(uint64_t* rows, size_t stride, int words) const {
+    const size_t rowWords = static_cast<size_t>(m_pitch) >> 6;
+    const int latticeWords = std::min(words, (m_cols + 31) / 32); // 32 nodes per maze word
+
+    for (int j = 0; j < m_rows; ++j) {
+        uint64_t* nodeRow = rows + static_cast<size_t>(2 * j + 1) * stride;
+        uint64_t* edgeRow = nodeRow + stride;
+        const size_t base = static_cast<size_t>(j + 1) * rowWords;
+        const bool southEdges = j + 1 < m_rows; // the last row's are never carved
+
+        for (int q = 0; q < latticeWords; ++q) {
+            const size_t lw = base + static_cast<size_t>(q >> 1);
+            const int shift = (q & 1) * 32;
+            uint64_t vis = (m_visited[lw] >> shift) & 0xFFFFFFFFull;
+            if (32 * q + 32 > m_cols) vis &= (uint64_t{1} << (m_cols - 32 * q)) - 1u; // drop sentinels
+            const uint64_t east = (m_east[lw] >> shift) & 0xFFFFFFFFull;
+
+            nodeRow[q] |= (SpreadBits(vis) << 1) | (SpreadBits(east) << 2);
+            if ((east >> 31) && q + 1 < words) nodeRow[q + 1] |= 1u;
+            if (southEdges) edgeRow[q] |= SpreadBits(m_south[lw] >> shift) << 1;
+        }
+    }
+}
+
+void CellLattice::Rasterize(Maze& maze) const {
+    const size_t words = static_cast<size_t>(maze.WordsPerRow());
+    std::vector<uint64_t> rows(static_cast<size_t>(maze.Height()) * words, 0u);
+    RasterizeRows(rows.data(), words, static_cast<int>(words));
+    maze.LoadRows(rows.data(), words);
+}
+
+} // namespace ml
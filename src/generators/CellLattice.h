@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "core/Maze.h"
+#include "core/RNG.h"
+#include "core/Types.h"
+
+namespace ml {
+
+enum class LatticeCarver : uint8_t { Backtracker, Prim };
+
+// Odd-cell node lattice shared by the carving generators: node (i, j) is maze
+// tile (2i + 1, 2j + 1) and an edge is the tile between two nodes. Per node it
+// keeps one visited bit, two carved-edge bits (east, south) and two bits of
+// carver scratch, instead of a byte per maze tile. Rows are padded with
+// always-visited sentinels, so neighbour tests need no bounds checks.
+// Rasterize writes the maze in one pass at the end.
+class CellLattice {
+public:
+    void Reset(int cols, int rows);
+    // Lattice of the odd tiles of a w x h maze (floor((w-1)/2) columns).
+    void ResetForMaze(int w, int h) { Reset((w - 1) / 2, (h - 1) / 2); }
+
+    int Cols() const noexcept { return m_cols; }
+    int Rows() const noexcept { return m_rows; }
+
+    // Node ids are padded indices; step N/E/S/W by -Pitch(), +1, +Pitch(), -1.
+    int Pitch() const noexcept { return m_pitch; }
+    int Node(int i, int j) const noexcept { return (j + 1) * m_pitch + i; }
+    int NodeAt(CellPos oddTile) const noexcept { return Node((oddTile.x - 1) / 2, (oddTile.y - 1) / 2); }
+
+    bool Visited(int n) const noexcept { return (m_visited[Word(n)] >> (n & 63)) & 1u; }
+    void MarkVisited(int n) noexcept { m_visited[Word(n)] |= uint64_t{1} << (n & 63); }
+
+    // Directions (Dir values) towards unvisited neighbours of n, in N, E, S, W
+    // order; returns the count.
+    int UnvisitedDirs(int n, int outDirs[4]) const noexcept;
+    int Step(int n, int d) const noexcept {
+        return d == 0 ? n - m_pitch : d == 1 ? n + 1 : d == 2 ? n + m_pitch : n - 1;
+    }
+
+    // Opens the edge from n towards direction d.
+    void Carve(int n, int d) noexcept;
+
+    // ORs the visited nodes and carved edges into bit-packed free rows laid out
+    // like Maze::RowWord (rows[0] is maze row 0, bit 0 of a word is column 0),
+    // writing at most `words` words per row.
+    void RasterizeRows(uint64_t* rows, size_t stride, int words) const;
+    // Replaces the contents of maze (already sized) with the lattice.
+    void Rasterize(Maze& maze) const;
+
+    // Carvers. Both only draw from rng when there is a real choice.
+    //   Backtracker: depth-first, parents kept in the scratch bits, no stack.
+    //   Prim: randomized Prim over frontier edges (packed node and direction).
+    // Resumable: BeginCarve, then CarveSome until it returns true. budget
+    // counts loop steps (a node carved, a backtrack or a frontier pop).
+    void BeginCarve(LatticeCarver carver, int startNode);
+    bool CarveSome(RNG& rng, long long budget);
+    void CarveAll(LatticeCarver carver, int startNode, RNG& rng) {
+        BeginCarve(carver, startNode);
+        CarveSome(rng, std::numeric_limits<long long>::max());
+    }
+
+    int NodeCount() const noexcept { return m_cols * m_rows; }
+    int CarvedNodes() const noexcept { return m_carved; }
+
+private:
+    static size_t Word(int n) noexcept { return static_cast<size_t>(n) >> 6; }
+    void Visit(int n) noexcept { MarkVisited(n); ++m_carved; }
+    bool BacktrackerSome(RNG& rng, long long budget);
+    bool PrimSome(RNG& rng, long long budget);
+    void PushFrontier(int n);
+
+    int m_cols{0};
+    int m_rows{0};
+    int m_pitch{0};                 // multiple of 64, at least m_cols + 1
+    std::vector<uint64_t> m_visited;
+    std::vector<uint64_t> m_east;   // edge to the east neighbour carved
+    std::vector<uint64_t> m_south;  // edge to the south neighbour carved
+    std::vector<uint64_t> m_parent; // 2 bits per node: direction back to the DFS parent
+    std::vector<uint32_t> m_frontier; // Prim: (node << 2) | direction from the tree node
+
+    LatticeCarver m_carver{LatticeCarver::Backtracker};
+    int m_startNode{0};
+    int m_cur{-1};  // backtracker position, -1 when done
+    int m_carved{0};
+};
+
+} // namespace ml
@@ -1,157 +1,321 @@
 #include "generators/CellularAutomataGenerator.h"
 
+#include "core/MazeComponents.h"
+
 #include <algorithm>
-#include <queue>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace ml {
 
-static bool HasPathBFS(const Maze& maze, CellPos start, CellPos goal) {
-    const int w = maze.Width();
-    const int h = maze.Height();
-    if (!maze.InBounds(start) || !maze.InBounds(goal)) return false;
-    if (maze.IsWall(start) || maze.IsWall(goal)) return false;
-
-    std::vector<uint8_t> vis(static_cast<size_t>(w * h), 0u);
-    auto idx = [&](CellPos p) { return static_cast<size_t>(ToIndex(p.x, p.y, w)); };
-
-    std::queue<CellPos> q;
-    q.push(start);
-    vis[idx(start)] = 1u;
-
-    while (!q.empty()) {
-        CellPos cur = q.front();
-        q.pop();
-        if (cur == goal) return true;
-
-        for (Dir d : kDirs) {
-            CellPos nxt = maze.Step(cur, d);
-            if (!maze.InBounds(nxt) || maze.IsWall(nxt)) continue;
-            auto i = idx(nxt);
-            if (vis[i]) continue;
-            vis[i] = 1u;
-            q.push(nxt);
+namespace {
+
+// Wall grids below are bit-packed like Maze rows but with 1 = wall, and every
+// row has one all-wall guard word on each side (stride = words + 2), so the
+// kernels need no edge cases and out-of-bounds reads as wall.
+
+void RandomWallFill(std::vector<uint64_t>& walls, int words, int y0, int y1, RNG& rng, uint32_t wallP16) {
+    // 64 Bernoulli(wallP16 / 65536) bits per word: compare 64 random 16-bit
+    // numbers, one bit from each of 16 random words, against wallP16 LSB first.
+    const size_t stride = static_cast<size_t>(words) + 2;
+    std::vector<uint64_t> rnd(static_cast<size_t>(words) * 16);
+    for (int y = y0; y < y1; ++y) {
+        uint64_t* row = walls.data() + static_cast<size_t>(y) * stride + 1;
+        rng.FillU64(rnd.data(), rnd.size());
+        for (int k = 0; k < words; ++k) {
+            const uint64_t* r = rnd.data() + static_cast<size_t>(k) * 16;
+            uint64_t below = 0u;
+            for (int j = 0; j < 16; ++j) {
+                below = ((wallP16 >> j) & 1u) ? (~r[j] | below) : (~r[j] & below);
+            }
+            row[k] = below;
         }
     }
-    return false;
 }
 
-int CellularAutomataGenerator::CountWallNeighbors8(const Maze& maze, int x, int y) {
-    int count = 0;
-    for (int dy = -1; dy <= 1; ++dy) {
-        for (int dx = -1; dx <= 1; ++dx) {
-            if (dx == 0 && dy == 0) continue;
-            const int nx = x + dx;
-            const int ny = y + dy;
-            if (nx < 0 || ny < 0 || nx >= maze.Width() || ny >= maze.Height()) {
-                // out of bounds treated as wall
-                count++;
-                continue;
-            }
-            if (maze.IsWall({nx, ny})) count++;
+void SmoothRows(const std::vector<uint64_t>& cur, std::vector<uint64_t>& next, int words, int y0, int y1) {
+    // Bit-sliced population count of the 8 neighbours (full/half adders on
+    // whole words), then the cave rule ">= 5 walls -> wall".
+    const size_t stride = static_cast<size_t>(words) + 2;
+    for (int y = y0; y < y1; ++y) {
+        const uint64_t* up = cur.data() + static_cast<size_t>(y - 1) * stride + 1;
+        const uint64_t* mid = up + stride;
+        const uint64_t* dn = mid + stride;
+        uint64_t* out = next.data() + static_cast<size_t>(y) * stride + 1;
+        for (int k = 0; k < words; ++k) {
+            const uint64_t n0 = (up[k] << 1) | (up[k - 1] >> 63);
+            const uint64_t n1 = up[k];
+            const uint64_t n2 = (up[k] >> 1) | (up[k + 1] << 63);
+            const uint64_t n3 = (mid[k] << 1) | (mid[k - 1] >> 63);
+            const uint64_t n4 = (mid[k] >> 1) | (mid[k + 1] << 63);
+            const uint64_t n5 = (dn[k] << 1) | (dn[k - 1] >> 63);
+            const uint64_t n6 = dn[k];
+            const uint64_t n7 = (dn[k] >> 1) | (dn[k + 1] << 63);
+
+            const uint64_t sa = n0 ^ n1 ^ n2, ca = (n0 & n1) | (n2 & (n0 ^ n1));
+            const uint64_t sb = n3 ^ n4 ^ n5, cb = (n3 & n4) | (n5 & (n3 ^ n4));
+            const uint64_t sc = n6 ^ n7, cc = n6 & n7;
+            const uint64_t b0 = sa ^ sb ^ sc, cd = (sa & sb) | (sc & (sa ^ sb));
+            // weight-2 terms ca, cb, cc, cd
+            const uint64_t t = ca ^ cb ^ cc, ce = (ca & cb) | (cc & (ca ^ cb));
+            const uint64_t b1 = t ^ cd, cf = t & cd;
+            // weight-4 terms ce, cf: count = 8*b3 + 4*b2 + 2*b1 + b0
+            const uint64_t b2 = ce ^ cf, b3 = ce & cf;
+            out[k] = b3 | (b2 & (b1 | b0));
         }
     }
-    return count;
 }
 
-void CellularAutomataGenerator::CarveManhattanCorridor(Maze& maze, CellPos start, CellPos goal) {
-    // Carve an L-shaped corridor (x then y). Always stays in bounds for interior points.
-    CellPos cur = start;
-    maze.SetFree(cur, true);
+// Generate() in slices. The fill and each smoothing pass cover a band of rows
+// per Step(), and so does loading the result into the maze. If start and exit
+// end up apart, a 0-1 BFS from start (free tiles cost 0, interior walls 1)
+// runs until it pops a tile of exit's component, and the walls on that path,
+// the fewest that join the two, are opened.
+class CellularGenTask final : public IGenTask {
+public:
+    explicit CellularGenTask(const MazeGenConfig& cfg);
+
+    bool Step(long long budget) override;
+    float Progress() const override;
+    void Finish(Maze& out) override { out = std::move(m_maze); }
+
+private:
+    enum class Phase { Fill, Smooth, Load, Label, JoinInit, Join, Release, Done };
+    static constexpr int kPasses = 5;
+    static constexpr uint32_t kWallP16 = 29491u; // interior wall probability ~45%
+
+    void FixRows(std::vector<uint64_t>& g) const;
+    void LoadRows(int rows);
+    void BeginJoin();
+    void OpenJoinPath(int end);
+
+    MazeGenConfig m_cfg;
+    RNG m_rng;
+    Maze m_maze;
+    int m_h;
+    int m_words;
+    size_t m_stride;
+    std::vector<uint64_t> m_edgeWalls;
+    std::vector<uint64_t> m_cur;
+    std::vector<uint64_t> m_next;
+
+    Phase m_phase{Phase::Fill};
+    int m_y{0};
+    int m_pass{0};
 
-    while (cur.x != goal.x) {
-        cur.x += (goal.x > cur.x) ? 1 : -1;
-        maze.SetFree(cur, true);
+    std::unique_ptr<MazeComponentsBuilder> m_labeler;
+    std::shared_ptr<const MazeComponents> m_comps;
+    int m_goalLabel{MazeComponents::kNone};
+    std::vector<int> m_dist;             // grown to Count() by JoinInit
+    std::unique_ptr<uint8_t[]> m_parent; // Dir of the step into each tile, written before it is read
+    std::deque<int> m_queue;
+    long long m_popped{0};
+};
+
+CellularGenTask::CellularGenTask(const MazeGenConfig& cfg)
+    : m_cfg(cfg), m_rng(cfg.randomSeed ? RNG() : RNG(cfg.seed)) {
+    m_maze.Resize(cfg.width, cfg.height);
+    const int w = m_maze.Width();
+    m_h = m_maze.Height();
+    m_words = m_maze.WordsPerRow();
+    m_stride = static_cast<size_t>(m_words) + 2;
+
+    // x = 0, x = w - 1 and the bits past the width are wall in every row
+    m_edgeWalls.assign(static_cast<size_t>(m_words), 0u);
+    m_edgeWalls[0] |= 1u;
+    m_edgeWalls[static_cast<size_t>((w - 1) >> 6)] |= uint64_t{1} << ((w - 1) & 63);
+    if (w & 63) m_edgeWalls.back() |= ~uint64_t{0} << (w & 63);
+
+    m_cur.assign(m_stride * static_cast<size_t>(m_h), ~uint64_t{0});
+    m_next.assign(m_cur.size(), ~uint64_t{0});
+}
+
+void CellularGenTask::FixRows(std::vector<uint64_t>& g) const {
+    // border rows all wall, border columns wall, start/exit open
+    std::fill(g.begin(), g.begin() + static_cast<std::ptrdiff_t>(m_stride), ~uint64_t{0});
+    std::fill(g.end() - static_cast<std::ptrdiff_t>(m_stride), g.end(), ~uint64_t{0});
+    for (int y = 1; y < m_h - 1; ++y) {
+        uint64_t* row = g.data() + static_cast<size_t>(y) * m_stride + 1;
+        for (int k = 0; k < m_words; ++k) row[k] |= m_edgeWalls[static_cast<size_t>(k)];
     }
-    while (cur.y != goal.y) {
-        cur.y += (goal.y > cur.y) ? 1 : -1;
-        maze.SetFree(cur, true);
+    for (CellPos p : {m_cfg.start, m_cfg.exit}) {
+        if (!m_maze.InBounds(p)) continue;
+        g[static_cast<size_t>(p.y) * m_stride + 1 + static_cast<size_t>(p.x >> 6)] &= ~(uint64_t{1} << (p.x & 63));
     }
+}
 
-    // Slightly widen around start/goal to avoid immediate dead-ends
-    for (int oy = -1; oy <= 1; ++oy) {
-        for (int ox = -1; ox <= 1; ++ox) {
-            CellPos a{start.x + ox, start.y + oy};
-            CellPos b{goal.x + ox, goal.y + oy};
-            if (maze.InBounds(a)) maze.SetFree(a, true);
-            if (maze.InBounds(b)) maze.SetFree(b, true);
-        }
+void CellularGenTask::LoadRows(int rows) {
+    const int y1 = m_maze.LoadRowsFrom(m_cur.data() + 1, m_stride, m_y, rows);
+    m_y = y1;
+    if (y1 < m_h) return;
+    m_labeler = std::make_unique<MazeComponentsBuilder>(m_maze);
+    m_phase = Phase::Label;
+}
+
+void CellularGenTask::BeginJoin() {
+    // Labels stay with the maze unless the join below changes it.
+    const MazeComponents& comps = *m_comps;
+    m_goalLabel = comps.Label(m_cfg.exit);
+    if (comps.Connected(m_cfg.start, m_cfg.exit) || m_goalLabel == MazeComponents::kNone ||
+        !m_maze.InBounds(m_cfg.start)) {
+        m_maze.AdoptComponents(std::move(m_comps));
+        m_phase = Phase::Done;
+        return;
     }
+    const size_t count = static_cast<size_t>(m_maze.Layout().Count());
+    m_dist.reserve(count);
+    m_parent = std::make_unique_for_overwrite<uint8_t[]>(count);
+    m_phase = Phase::JoinInit;
 }
 
-void CellularAutomataGenerator::Generate(Maze& maze, const MazeGenConfig& cfg) {
-    RNG rng(cfg.randomSeed ? RNG() : RNG(cfg.seed));
-    if (cfg.randomSeed) {
-        // RNG() already seeds itself; nothing to do
+void CellularGenTask::OpenJoinPath(int end) {
+    const CellLayout& layout = m_maze.Layout();
+    const MazeComponents& comps = *m_comps;
+    const int si = layout.Index(m_cfg.start);
+    std::vector<int> toOpen;
+    for (int ci = end;; ci = layout.Step(ci, TurnBack(static_cast<Dir>(m_parent[static_cast<size_t>(ci)])))) {
+        if (comps.LabelAt(ci) == MazeComponents::kNone) toOpen.push_back(ci);
+        if (ci == si) break;
     }
+    for (int ci : toOpen) m_maze.SetFree(layout.Pos(ci), true);
+}
 
-    maze.Resize(cfg.width, cfg.height);
-
-    // Initial random fill.
-    // Border is wall. Interior is wall with probability p.
-    const int pWall = 45; // %
-    for (int y = 0; y < cfg.height; ++y) {
-        for (int x = 0; x < cfg.width; ++x) {
-            const bool border = (x == 0 || y == 0 || x == cfg.width - 1 || y == cfg.height - 1);
-            bool wall = border;
-            if (!border) {
-                wall = (rng.NextInt(0, 99) < pWall);
+bool CellularGenTask::Step(long long budget) {
+    while (budget > 0 && m_phase != Phase::Done) {
+        switch (m_phase) {
+        case Phase::Fill: {
+            const int rows = static_cast<int>(std::clamp<long long>(budget / m_words, 1, m_h - m_y));
+            RandomWallFill(m_cur, m_words, m_y, m_y + rows, m_rng, kWallP16);
+            m_y += rows;
+            budget -= static_cast<long long>(rows) * m_words;
+            if (m_y == m_h) {
+                FixRows(m_cur);
+                m_phase = Phase::Smooth;
+                m_y = 1;
             }
-            maze.SetFree({x, y}, !wall);
+            break;
         }
-    }
-
-    // Ensure start/exit are open before smoothing.
-    maze.SetFree(cfg.start, true);
-    maze.SetFree(cfg.exit, true);
-
-    // Cellular automata smoothing
-    const int iters = 5;
-    std::vector<uint8_t> next(static_cast<size_t>(cfg.width * cfg.height), 1u);
-    auto setNext = [&](int x, int y, bool free) {
-        next[static_cast<size_t>(ToIndex(x, y, cfg.width))] = free ? 0u : 1u;
-    };
-
-    for (int it = 0; it < iters; ++it) {
-        for (int y = 0; y < cfg.height; ++y) {
-            for (int x = 0; x < cfg.width; ++x) {
-                const bool border = (x == 0 || y == 0 || x == cfg.width - 1 || y == cfg.height - 1);
-                if (border) {
-                    setNext(x, y, false);
-                    continue;
+        case Phase::Smooth: {
+            // double-buffered: rows of m_next from m_cur, swapped after each pass
+            const int rows = static_cast<int>(std::clamp<long long>(budget / m_words, 1, m_h - 1 - m_y));
+            SmoothRows(m_cur, m_next, m_words, m_y, m_y + rows);
+            m_y += rows;
+            budget -= static_cast<long long>(rows) * m_words;
+            if (m_y == m_h - 1) {
+                FixRows(m_next);
+                m_cur.swap(m_next);
+                m_y = 1;
+                if (++m_pass == kPasses) {
+                    for (uint64_t& word : m_cur) word = ~word; // walls -> free bits
+                    m_phase = Phase::Load;
+                    m_y = 0;
                 }
-
-                int walls8 = CountWallNeighbors8(maze, x, y);
-                // Typical cave rule: >=5 walls -> wall, else free
-                bool willBeWall = (walls8 >= 5);
-                setNext(x, y, !willBeWall);
             }
+            break;
         }
-
-        // Commit
-        for (int y = 0; y < cfg.height; ++y) {
-            for (int x = 0; x < cfg.width; ++x) {
-                bool free = next[static_cast<size_t>(ToIndex(x, y, cfg.width))] == 0u;
-                maze.SetFree({x, y}, free);
+        case Phase::Load: {
+            const int rows = static_cast<int>(std::clamp<long long>(budget / m_words, 1, m_h));
+            const int y0 = m_y;
+            LoadRows(rows);
+            budget -= static_cast<long long>(std::max(1, m_y - y0)) * m_words;
+            break;
+        }
+        case Phase::Label:
+            if (!m_labeler->Step(budget)) return false;
+            m_comps = m_labeler->Take();
+            m_labeler.reset();
+            BeginJoin();
+            return m_phase == Phase::Done;
+        case Phase::JoinInit: {
+            const size_t count = static_cast<size_t>(m_maze.Layout().Count());
+            const size_t step = static_cast<size_t>(std::min<long long>(budget, 1 << 20)) * 64;
+            m_dist.resize(std::min(count, m_dist.size() + step), std::numeric_limits<int>::max());
+            budget -= static_cast<long long>(step / 64);
+            if (m_dist.size() == count) {
+                const int si = m_maze.Layout().Index(m_cfg.start);
+                m_dist[static_cast<size_t>(si)] = 0;
+                m_queue.push_back(si);
+                m_phase = Phase::Join;
             }
+            break;
         }
+        case Phase::Join: {
+            const CellLayout& layout = m_maze.Layout();
+            const MazeComponents& comps = *m_comps;
+            const int w = m_maze.Width();
+            int end = -1;
+            for (; budget > 0 && !m_queue.empty(); --budget) {
+                const int ci = m_queue.front();
+                m_queue.pop_front();
+                ++m_popped;
+                if (comps.LabelAt(ci) == m_goalLabel) { end = ci; break; }
 
-        maze.SetFree(cfg.start, true);
-        maze.SetFree(cfg.exit, true);
-    }
-
-    // Guarantee connectivity.
-    if (!HasPathBFS(maze, cfg.start, cfg.exit)) {
-        CarveManhattanCorridor(maze, cfg.start, cfg.exit);
-    }
-    // Final guarantee (rare): if still no path, fully open interior corridor area.
-    if (!HasPathBFS(maze, cfg.start, cfg.exit)) {
-        for (int y = 1; y < cfg.height - 1; ++y) {
-            for (int x = 1; x < cfg.width - 1; ++x) {
-                maze.SetFree({x, y}, true);
+                for (Dir d : kDirs) {
+                    const int ni = layout.Step(ci, d);
+                    const CellPos np = layout.Pos(ni);
+                    // border stays wall
+                    if (np.x <= 0 || np.y <= 0 || np.x >= w - 1 || np.y >= m_h - 1) continue;
+                    const int cost = (comps.LabelAt(ni) == MazeComponents::kNone) ? 1 : 0;
+                    const int nd = m_dist[static_cast<size_t>(ci)] + cost;
+                    if (nd >= m_dist[static_cast<size_t>(ni)]) continue;
+                    m_dist[static_cast<size_t>(ni)] = nd;
+                    m_parent[static_cast<size_t>(ni)] = static_cast<uint8_t>(d);
+                    if (cost) m_queue.push_back(ni);
+                    else m_queue.push_front(ni);
+                }
             }
+            if (end == -1 && !m_queue.empty()) return false;
+            if (end != -1) OpenJoinPath(end);
+            m_phase = Phase::Release;
+            return false;
+        }
+        case Phase::Release:
+            // a buffer per step: unmapping a few hundred MB takes tens of ms each
+            if (m_comps) m_comps.reset(); // stale once the walls are opened
+            else if (m_parent) m_parent.reset();
+            else if (!m_dist.empty()) m_dist = std::vector<int>();
+            else {
+                m_queue = std::deque<int>();
+                m_phase = Phase::Done;
+                break;
+            }
+            return false;
+        case Phase::Done:
+            break;
         }
-        CarveManhattanCorridor(maze, cfg.start, cfg.exit);
     }
+    return m_phase == Phase::Done;
+}
+
+float CellularGenTask::Progress() const {
+    // fill 10%, smoothing 45%, load 5%, labels 20%, join 20% (by tiles popped, an upper bound)
+    const float h = static_cast<float>(m_h);
+    switch (m_phase) {
+    case Phase::Fill: return 0.1f * static_cast<float>(m_y) / h;
+    case Phase::Smooth: return 0.1f + 0.45f * (static_cast<float>(m_pass) + static_cast<float>(m_y) / h) / kPasses;
+    case Phase::Load: return 0.55f + 0.05f * static_cast<float>(m_y) / h;
+    case Phase::Label: return 0.6f + 0.2f * m_labeler->Progress();
+    case Phase::JoinInit: return 0.8f;
+    case Phase::Release: return 1.f;
+    case Phase::Join:
+        return 0.8f + 0.2f * std::min(1.f, static_cast<float>(m_popped) / static_cast<float>(m_maze.Layout().Count()));
+    case Phase::Done: break;
+    }
+    return 1.f;
+}
+
+} // namespace
+
+void CellularAutomataGenerator::Generate(Maze& maze, const MazeGenConfig& cfg) {
+    CellularGenTask task(cfg);
+    while (!task.Step(std::numeric_limits<long long>::max())) {}
+    task.Finish(maze);
+}
+
+std::unique_ptr<IGenTask> CellularAutomataGenerator::Begin(const MazeGenConfig& cfg) {
+    return std::make_unique<CellularGenTask>(cfg);
 }
 
 } // namespace ml
@@ -10,10 +10,9 @@ class CellularAutomataGenerator final : public IMazeGenerator {
 public:
     std::string Name() const override { return "Cellular Automata"; }
     void Generate(Maze& maze, const MazeGenConfig& cfg) override;
-
-private:
-    static int CountWallNeighbors8(const Maze& maze, int x, int y);
-    static void CarveManhattanCorridor(Maze& maze, CellPos start, CellPos goal);
+    // Random fill and smoothing run a band of rows per Step(); labelling and
+    // the start/exit join are sliced as well.
+    std::unique_ptr<IGenTask> Begin(const MazeGenConfig& cfg) override;
 };
 
 } // namespace ml
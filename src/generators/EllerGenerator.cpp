@@ -0,0 +1,182 @@
+#include "generators/EllerGenerator.h"
+#include "core/DisjointSet.h"
+#include "core/MazeFile.h"
+#include <algorithm>
+#include <vector>
+
+namespace ml {
+
+static constexpr uint32_t kEllerGeneratorIndex = 3; // SimConfig::generatorIndex
+
+static void SetBit(std::vector<uint64_t>& row, int x) {
+    row[static_cast<size_t>(x >> 6)] |= uint64_t{1} << (x & 63);
+}
+
+EllerRowStream::EllerRowStream(int width, int height, uint64_t seed)
+    : m_w(std::max(3, width))
+    , m_h(std::max(3, height))
+    , m_cols((m_w - 1) / 2) // lattice node (i, r) is tile (2i + 1, 2r + 1)
+    , m_rows((m_h - 1) / 2)
+    , m_words(static_cast<size_t>((m_w + 63) / 64))
+    , m_rng(seed)
+    , m_set(static_cast<size_t>(m_cols), -1)
+    , m_parent(static_cast<size_t>(m_cols))
+    , m_remaining(static_cast<size_t>(m_cols))
+    , m_rename(static_cast<size_t>(m_cols))
+    , m_wentDown(static_cast<size_t>(m_cols))
+    , m_nodes(m_words, 0u)
+    , m_nodeRow(m_words)
+    , m_edgeRow(m_words)
+    , m_wallRow(m_words, 0u)
+{
+    for (int i = 0; i < m_cols; ++i) SetBit(m_nodes, 2 * i + 1);
+}
+
+// One fresh random bit per decision, drawn a word at a time.
+uint64_t EllerRowStream::Coin(int i) {
+    if ((i & 63) == 0) m_coinBits = m_rng.NextU64();
+    return (m_coinBits >> (i & 63)) & 1u;
+}
+
+const uint64_t* EllerRowStream::NextRow() {
+    const int y = m_y++;
+    // rows 2r + 1 (nodes and east edges) and 2r + 2 (south edges) per lattice
+    // row; the rest is border (two wall rows at the bottom when h is even)
+    if (y == 2 * m_r + 1 && m_r < m_rows) {
+        BuildLatticeRow(m_r + 1 == m_rows);
+        return m_nodeRow.data();
+    }
+    if (y == 2 * m_r + 2 && m_r < m_rows) {
+        ++m_r;
+        return m_edgeRow.data();
+    }
+    return m_wallRow.data();
+}
+
+void EllerRowStream::BuildLatticeRow(bool last) {
+    const int cols = m_cols;
+    for (int i = 0; i < cols; ++i) {
+        if (m_set[static_cast<size_t>(i)] < 0) m_set[static_cast<size_t>(i)] = i;
+        m_parent[static_cast<size_t>(i)] = i;
+    }
+
+    // join neighbours of different sets at random (all of them on the last row);
+    // written without data-dependent branches, the coin flips are unpredictable
+    m_nodeRow = m_nodes;
+    int a = m_set[0];
+    for (int i = 0; i + 1 < cols; ++i) {
+        const int b = FindRoot(m_parent, m_set[static_cast<size_t>(i + 1)]);
+        const uint64_t join = static_cast<uint64_t>(a != b) & (static_cast<uint64_t>(last) | Coin(i));
+        m_parent[static_cast<size_t>(b)] = join ? a : b; // cell i + 1 now has root a
+        m_nodeRow[static_cast<size_t>((2 * i + 2) >> 6)] |= join << ((2 * i + 2) & 63);
+        a = join ? a : b;
+    }
+    for (int& id : m_set) id = FindRoot(m_parent, id);
+
+    // every set continues down through at least one of its cells
+    std::fill(m_edgeRow.begin(), m_edgeRow.end(), uint64_t{0});
+    if (last) return;
+    std::fill(m_remaining.begin(), m_remaining.end(), 0);
+    std::fill(m_wentDown.begin(), m_wentDown.end(), uint8_t{0});
+    for (int id : m_set) ++m_remaining[static_cast<size_t>(id)];
+    for (int i = 0; i < cols; ++i) {
+        const size_t id = static_cast<size_t>(m_set[static_cast<size_t>(i)]);
+        const bool lastOfSet = --m_remaining[id] == 0;
+        const bool down = Coin(i) | (lastOfSet & !m_wentDown[id]);
+        const bool first = down & !m_wentDown[id];
+        m_rename[id] = first ? i : m_rename[id];
+        m_wentDown[id] |= static_cast<uint8_t>(down);
+        m_set[static_cast<size_t>(i)] = down ? m_rename[id] : -1;
+        m_edgeRow[static_cast<size_t>((2 * i + 1) >> 6)] |= static_cast<uint64_t>(down) << ((2 * i + 1) & 63);
+    }
+}
+
+bool EllerGenerator::Stream(int width, int height, uint64_t seed, const RowSink& sink) {
+    EllerRowStream stream(width, height, seed);
+    while (!stream.Done()) {
+        const int y = stream.NextY();
+        if (!sink(y, stream.NextRow())) return false;
+    }
+    return true;
+}
+
+namespace {
+
+// Rows go into a full-size buffer, a budget of cells at a time.
+class EllerGenTask final : public IGenTask {
+public:
+    EllerGenTask(int width, int height, uint64_t seed)
+        : m_stream(width, height, seed)
+        , m_rows(static_cast<size_t>(m_stream.Height()) * static_cast<size_t>(m_stream.WordsPerRow()), 0u) {}
+
+    bool Step(long long budget) override {
+        const size_t words = static_cast<size_t>(m_stream.WordsPerRow());
+        for (long long spent = 0; spent < budget && !m_stream.Done(); spent += m_stream.Width()) {
+            const size_t y = static_cast<size_t>(m_stream.NextY());
+            const uint64_t* row = m_stream.NextRow();
+            std::copy(row, row + words, m_rows.begin() + static_cast<std::ptrdiff_t>(y * words));
+        }
+        return m_stream.Done();
+    }
+    float Progress() const override { return static_cast<float>(m_stream.NextY()) / static_cast<float>(m_stream.Height()); }
+    bool Preview(Maze& out) const override {
+        Load(out);
+        return true;
+    }
+    void Finish(Maze& out) override { Load(out); }
+
+private:
+    void Load(Maze& out) const {
+        if (out.Width() != m_stream.Width() || out.Height() != m_stream.Height()) out.Resize(m_stream.Width(), m_stream.Height());
+        out.LoadRows(m_rows.data(), static_cast<size_t>(m_stream.WordsPerRow()));
+    }
+
+    EllerRowStream m_stream;
+    std::vector<uint64_t> m_rows;
+};
+
+} // namespace
+
+std::unique_ptr<IGenTask> EllerGenerator::Begin(const MazeGenConfig& cfg) {
+    const uint64_t seed = cfg.randomSeed ? RNG().NextU32() : cfg.seed;
+    return std::make_unique<EllerGenTask>(GenWidth(cfg), GenHeight(cfg), seed);
+}
+
+void EllerGenerator::Generate(Maze& maze, const MazeGenConfig& cfg) {
+    maze.Resize(cfg.width, cfg.height);
+    const size_t words = static_cast<size_t>(maze.WordsPerRow());
+    std::vector<uint64_t> rows(static_cast<size_t>(maze.Height()) * words, 0u);
+    GenScratch scratch;
+    GenerateRows(cfg, rows.data(), words, scratch);
+    maze.LoadRows(rows.data(), words);
+}
+
+void EllerGenerator::GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch&) {
+    const uint64_t seed = cfg.randomSeed ? RNG().NextU32() : cfg.seed;
+    const size_t words = static_cast<size_t>((GenWidth(cfg) + 63) / 64);
+
+    // Every odd tile is carved, so start and exit (odd) are free.
+    Stream(GenWidth(cfg), GenHeight(cfg), seed, [&](int y, const uint64_t* freeWords) {
+        std::copy(freeWords, freeWords + words, rows + static_cast<size_t>(y) * stride);
+        return true;
+    });
+}
+
+bool EllerGenerator::WriteFile(const std::string& path, int width, int height, uint64_t seed) {
+    const int w = std::max(3, width);
+    const int h = std::max(3, height);
+    MazeMeta meta;
+    meta.start = {1, 1};
+    meta.exit = {(w - 2) | 1, (h - 2) | 1};
+    if (meta.exit.x > w - 2) meta.exit.x -= 2;
+    if (meta.exit.y > h - 2) meta.exit.y -= 2;
+    meta.generator = kEllerGeneratorIndex;
+    meta.seed = seed;
+
+    MazeFileWriter writer;
+    if (!writer.Open(path, w, h, meta)) return false;
+    const bool complete = Stream(w, h, seed, [&](int, const uint64_t* freeWords) { return writer.WriteRow(freeWords); });
+    return writer.Close() && complete;
+}
+
+} // namespace ml
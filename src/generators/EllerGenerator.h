@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "generators/IMazeGenerator.h"
+
+namespace ml {
+
+// Eller's algorithm, pull style: NextRow() finishes the maze one row at a
+// time keeping only O(width) set state, so the height is not limited by memory.
+class EllerRowStream {
+public:
+    EllerRowStream(int width, int height, uint64_t seed);
+
+    int Width() const noexcept { return m_w; }
+    int Height() const noexcept { return m_h; }
+    int WordsPerRow() const noexcept { return static_cast<int>(m_words); }
+
+    bool Done() const noexcept { return m_y >= m_h; }
+    int NextY() const noexcept { return m_y; }
+    // Row NextY() as bit-packed words (Maze::RowWord layout, 1 = free), valid
+    // until the next call. Not to be called once Done().
+    const uint64_t* NextRow();
+
+private:
+    void BuildLatticeRow(bool last);
+    uint64_t Coin(int i);
+
+    int m_w;
+    int m_h;
+    int m_cols;
+    int m_rows;
+    size_t m_words;
+    int m_y{0};
+    int m_r{0}; // next lattice row
+
+    RNG m_rng;
+    uint64_t m_coinBits{0};
+
+    // A set is named by the index of one of its cells in the current row, so a
+    // cell that did not come down from the row above can simply use its own.
+    std::vector<int> m_set;
+    std::vector<int> m_parent;
+    std::vector<int> m_remaining;
+    std::vector<int> m_rename; // set -> its first cell going down
+    std::vector<uint8_t> m_wentDown;
+
+    std::vector<uint64_t> m_nodes; // node tiles of every lattice row
+    std::vector<uint64_t> m_nodeRow;
+    std::vector<uint64_t> m_edgeRow;
+    std::vector<uint64_t> m_wallRow;
+};
+
+// Perfect maze by Eller's algorithm. Stream() hands the rows to a sink as
+// they are finished; Generate() and Begin() collect them into a Maze.
+class EllerGenerator final : public IMazeGenerator {
+public:
+    // Maze row y as WordsPerRow() bit-packed words (Maze::RowWord layout,
+    // 1 = free). The buffer is reused for the next row. Return false to stop.
+    using RowSink = std::function<bool(int y, const uint64_t* freeWords)>;
+
+    std::string Name() const override { return "Eller"; }
+    void Generate(Maze& maze, const MazeGenConfig& cfg) override;
+    void GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch& scratch) override;
+    std::unique_ptr<IGenTask> Begin(const MazeGenConfig& cfg) override;
+
+    // Emits rows 0..height-1 in order; false if the sink stopped early.
+    static bool Stream(int width, int height, uint64_t seed, const RowSink& sink);
+    // Streams straight into an .mlzb file (start (1,1), exit at the far corner).
+    static bool WriteFile(const std::string& path, int width, int height, uint64_t seed);
+};
+
+} // namespace ml
@@ -1,9 +1,13 @@
 #pragma once
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <cstdint>
+#include <utility>
 #include "core/Maze.h"
 #include "core/RNG.h"
 #include "core/Types.h"
+#include "generators/CellLattice.h"
 
 namespace ml {
 
@@ -14,6 +18,34 @@ struct MazeGenConfig {
     bool randomSeed{false};
     CellPos start{1,1};
     CellPos exit{29,29};
+    // DFS/Prim: carve 64x64 tiles in parallel and stitch them (TiledGeneration.h).
+    // Gives different mazes than the sequential path, identical for any thread count.
+    bool tiled{false};
+    int threads{0}; // worker cap for tiled mode and GenerateBatch, 0 = all cores
+};
+
+// Maze size a config produces (Maze::Resize keeps sides >= 3).
+inline int GenWidth(const MazeGenConfig& cfg) { return std::max(3, cfg.width); }
+inline int GenHeight(const MazeGenConfig& cfg) { return std::max(3, cfg.height); }
+
+// Buffers a generator may keep between GenerateRows calls (one per worker).
+struct GenScratch {
+    CellLattice lattice;
+    Maze maze;
+};
+
+// Resumable generation, for callers that must not block (the UI spends a few
+// milliseconds per frame on it). Step() does up to `budget` units of work
+// (about one node or cell each) and returns true once the maze is complete;
+// Finish() then writes it to the output.
+class IGenTask {
+public:
+    virtual ~IGenTask() = default;
+    virtual bool Step(long long budget) = 0;
+    virtual float Progress() const = 0; // 0..1
+    // Writes the maze carved so far into out; false if the task has none to show.
+    virtual bool Preview(Maze& out) const { (void)out; return false; }
+    virtual void Finish(Maze& out) = 0;
 };
 
 class IMazeGenerator {
@@ -21,6 +53,46 @@ public:
     virtual ~IMazeGenerator() = default;
     virtual std::string Name() const = 0;
     virtual void Generate(Maze& maze, const MazeGenConfig& cfg) = 0;
+
+    // Writes the maze as bit-packed free rows (Maze::RowWord layout, stride
+    // words per row, GenHeight rows), which must be all zero on entry. Used
+    // by GenerateBatch from several threads at once, so it must not touch
+    // generator state. The default goes through scratch.maze.
+    virtual void GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch& scratch) {
+        Generate(scratch.maze, cfg);
+        const Maze& m = scratch.maze;
+        for (int y = 0; y < m.Height(); ++y) {
+            for (int k = 0; k < m.WordsPerRow(); ++k) rows[static_cast<size_t>(y) * stride + static_cast<size_t>(k)] = m.RowWord(y, k);
+        }
+    }
+
+    // Starts a resumable generation of cfg. The default does all the work in
+    // the first Step() (for generators that cannot be sliced).
+    virtual std::unique_ptr<IGenTask> Begin(const MazeGenConfig& cfg);
 };
 
+// IGenTask that runs IMazeGenerator::Generate in one step.
+class OneShotGenTask final : public IGenTask {
+public:
+    OneShotGenTask(IMazeGenerator& generator, const MazeGenConfig& cfg) : m_generator(generator), m_cfg(cfg) {}
+
+    bool Step(long long) override {
+        if (!m_done) m_generator.Generate(m_maze, m_cfg);
+        m_done = true;
+        return true;
+    }
+    float Progress() const override { return m_done ? 1.f : 0.f; }
+    void Finish(Maze& out) override { out = std::move(m_maze); }
+
+private:
+    IMazeGenerator& m_generator;
+    MazeGenConfig m_cfg;
+    Maze m_maze;
+    bool m_done{false};
+};
+
+inline std::unique_ptr<IGenTask> IMazeGenerator::Begin(const MazeGenConfig& cfg) {
+    return std::make_unique<OneShotGenTask>(*this, cfg);
+}
+
 } // namespace ml
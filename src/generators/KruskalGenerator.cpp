@@ -0,0 +1,246 @@
+#include "generators/KruskalGenerator.h"
+#include "core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+namespace ml {
+
+namespace {
+
+constexpr uint64_t kBatchEdges = uint64_t{1} << 16; // positions per batch
+constexpr int kBatchParts = 16;                      // parallel chunks of a batch
+
+uint64_t Mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Keyed bijection of [0, count): a balanced Feistel network over the smallest
+// even bit width holding count, cycle-walked back into range (fewer than four
+// passes on average).
+class EdgePermutation {
+public:
+    EdgePermutation(uint64_t count, uint64_t seed) : m_count(count) {
+        int bits = 1;
+        while (bits < 64 && (uint64_t{1} << bits) < count) ++bits;
+        m_half = (bits + 1) / 2;
+        m_mask = (uint64_t{1} << m_half) - 1u;
+        RNG rng(seed);
+        for (uint64_t& k : m_keys) k = rng.NextU64();
+    }
+
+    uint64_t operator()(uint64_t i) const noexcept {
+        do {
+            uint64_t l = i >> m_half;
+            uint64_t r = i & m_mask;
+            for (uint64_t k : m_keys) {
+                const uint64_t next = l ^ (Mix64(r ^ k) & m_mask);
+                l = r;
+                r = next;
+            }
+            i = (l << m_half) | r;
+        } while (i >= m_count);
+        return i;
+    }
+
+private:
+    uint64_t m_count;
+    int m_half{1};
+    uint64_t m_mask{1};
+    uint64_t m_keys[4]{};
+};
+
+// Root of x with path halving. Safe to run from several threads while no
+// links happen: each store only moves a node closer to the same root.
+uint32_t FindRoot(std::atomic<uint32_t>* parent, uint32_t x) {
+    for (;;) {
+        const uint32_t p = parent[x].load(std::memory_order_relaxed);
+        if (p == x) return x;
+        const uint32_t gp = parent[p].load(std::memory_order_relaxed);
+        if (gp != p) parent[x].store(gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+// Resumable Kruskal writing straight into bit-packed free rows.
+class KruskalCarve {
+public:
+    KruskalCarve(int w, int h, uint64_t seed, int threads, uint64_t* rows, size_t stride)
+        : m_cols((w - 1) / 2)
+        , m_rows((h - 1) / 2)
+        , m_threads(threads)
+        , m_filter(threads != 1 && ThreadPool::Shared().Size() > 1)
+        , m_out(rows)
+        , m_stride(stride)
+        , m_nodes(static_cast<uint32_t>(m_cols) * static_cast<uint32_t>(m_rows))
+        , m_eastEdges(static_cast<uint64_t>(m_cols - 1) * static_cast<uint64_t>(m_rows))
+        , m_edges(m_eastEdges + static_cast<uint64_t>(m_cols) * static_cast<uint64_t>(m_rows - 1))
+        , m_order(m_edges, seed)
+    {
+        m_parent = std::make_unique<std::atomic<uint32_t>[]>(m_nodes);
+        for (uint32_t n = 0; n < m_nodes; ++n) m_parent[n].store(n, std::memory_order_relaxed);
+        for (auto& part : m_survivors) part.reserve(static_cast<size_t>(kBatchEdges / kBatchParts));
+
+        // every node is free, edges start as walls
+        const int words = (w + 63) / 64;
+        for (int y = 0; y < h; ++y) {
+            uint64_t* row = m_out + static_cast<size_t>(y) * m_stride;
+            for (int k = 0; k < words; ++k) row[k] = 0u;
+            if ((y & 1) == 0 || y > 2 * m_rows) continue;
+            for (int i = 0; i < m_cols; ++i) row[(2 * i + 1) >> 6] |= uint64_t{1} << ((2 * i + 1) & 63);
+        }
+    }
+
+    bool Done() const noexcept { return m_next >= m_edges || m_joined + 1 >= m_nodes; }
+    float Progress() const noexcept {
+        return m_nodes > 1 ? static_cast<float>(m_joined) / static_cast<float>(m_nodes - 1) : 1.f;
+    }
+
+    // Goes through up to `budget` more edge positions. Batch boundaries do not
+    // change the result, only how much is filtered in parallel.
+    bool Step(long long budget) {
+        while (budget > 0 && !Done()) {
+            const uint64_t n = std::min(kBatchEdges, static_cast<uint64_t>(budget));
+            RunBatch(n);
+            budget -= static_cast<long long>(n);
+        }
+        return Done();
+    }
+
+private:
+    void Ends(uint64_t e, uint32_t& a, uint32_t& b) const noexcept {
+        const uint32_t cols = static_cast<uint32_t>(m_cols);
+        if (e < m_eastEdges) {
+            const uint32_t j = static_cast<uint32_t>(e / (cols - 1));
+            a = j * cols + static_cast<uint32_t>(e % (cols - 1));
+            b = a + 1;
+        } else {
+            a = static_cast<uint32_t>(e - m_eastEdges);
+            b = a + cols;
+        }
+    }
+
+    void RunBatch(uint64_t count) {
+        const uint64_t begin = m_next;
+        const uint64_t end = std::min(m_edges, begin + count);
+        const uint64_t part = (end - begin + kBatchParts - 1) / kBatchParts;
+
+        // parallel filter: keep the edges not already inside one tree (on a
+        // single thread it would only repeat the joining pass's lookups)
+        std::atomic<uint32_t>* parent = m_parent.get();
+        ThreadPool::Shared().ParallelFor(kBatchParts, [&](int p, int) {
+            std::vector<uint64_t>& out = m_survivors[static_cast<size_t>(p)];
+            out.clear();
+            const uint64_t lo = std::min(end, begin + part * static_cast<uint64_t>(p));
+            const uint64_t hi = std::min(end, lo + part);
+            for (uint64_t i = lo; i < hi; ++i) {
+                const uint64_t e = m_order(i);
+                uint32_t a, b;
+                Ends(e, a, b);
+                if (!m_filter || FindRoot(parent, a) != FindRoot(parent, b)) out.push_back(e);
+            }
+        }, m_threads);
+
+        // join in permutation order
+        for (const auto& out : m_survivors) {
+            for (uint64_t e : out) {
+                uint32_t a, b;
+                Ends(e, a, b);
+                const uint32_t ra = FindRoot(parent, a);
+                const uint32_t rb = FindRoot(parent, b);
+                if (ra == rb) continue;
+                parent[std::max(ra, rb)].store(std::min(ra, rb), std::memory_order_relaxed);
+                ++m_joined;
+                OpenEdge(e, a);
+            }
+        }
+        m_next = end;
+    }
+
+    void OpenEdge(uint64_t e, uint32_t a) {
+        const int i = static_cast<int>(a % static_cast<uint32_t>(m_cols));
+        const int j = static_cast<int>(a / static_cast<uint32_t>(m_cols));
+        const bool east = e < m_eastEdges;
+        const int x = east ? 2 * i + 2 : 2 * i + 1;
+        const size_t y = static_cast<size_t>(east ? 2 * j + 1 : 2 * j + 2);
+        m_out[y * m_stride + static_cast<size_t>(x >> 6)] |= uint64_t{1} << (x & 63);
+    }
+
+    int m_cols;
+    int m_rows;
+    int m_threads;
+    bool m_filter;
+    uint64_t* m_out;
+    size_t m_stride;
+
+    uint32_t m_nodes;
+    uint64_t m_eastEdges;
+    uint64_t m_edges;
+    EdgePermutation m_order;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_parent;
+    std::vector<uint64_t> m_survivors[kBatchParts];
+
+    uint64_t m_next{0};   // next permutation position
+    uint32_t m_joined{0}; // edges opened
+};
+
+uint64_t KruskalSeed(const MazeGenConfig& cfg) {
+    return cfg.randomSeed ? RNG().NextU32() : cfg.seed;
+}
+
+class KruskalGenTask final : public IGenTask {
+public:
+    KruskalGenTask(int w, int h, uint64_t seed, int threads)
+        : m_w(w)
+        , m_h(h)
+        , m_words(static_cast<size_t>((w + 63) / 64))
+        , m_rows(static_cast<size_t>(h) * m_words)
+        , m_carve(w, h, seed, threads, m_rows.data(), m_words) {}
+
+    bool Step(long long budget) override { return m_carve.Step(budget); }
+    float Progress() const override { return m_carve.Progress(); }
+    bool Preview(Maze& out) const override {
+        Load(out);
+        return true;
+    }
+    void Finish(Maze& out) override { Load(out); }
+
+private:
+    void Load(Maze& out) const {
+        if (out.Width() != m_w || out.Height() != m_h) out.Resize(m_w, m_h);
+        out.LoadRows(m_rows.data(), m_words);
+    }
+
+    int m_w;
+    int m_h;
+    size_t m_words;
+    std::vector<uint64_t> m_rows;
+    KruskalCarve m_carve;
+};
+
+} // namespace
+
+void KruskalGenerator::Generate(Maze& maze, const MazeGenConfig& cfg) {
+    maze.Resize(cfg.width, cfg.height);
+    const size_t words = static_cast<size_t>(maze.WordsPerRow());
+    std::vector<uint64_t> rows(static_cast<size_t>(maze.Height()) * words, 0u);
+    GenScratch scratch;
+    GenerateRows(cfg, rows.data(), words, scratch);
+    maze.LoadRows(rows.data(), words);
+}
+
+void KruskalGenerator::GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch&) {
+    // Every odd tile is free, so start and exit (odd) are too.
+    KruskalCarve carve(GenWidth(cfg), GenHeight(cfg), KruskalSeed(cfg), cfg.threads, rows, stride);
+    carve.Step(std::numeric_limits<long long>::max());
+}
+
+std::unique_ptr<IGenTask> KruskalGenerator::Begin(const MazeGenConfig& cfg) {
+    return std::make_unique<KruskalGenTask>(GenWidth(cfg), GenHeight(cfg), KruskalSeed(cfg), cfg.threads);
+}
+
+} // namespace ml
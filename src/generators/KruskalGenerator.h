@@ -0,0 +1,24 @@
+#pragma once
+#include "generators/IMazeGenerator.h"
+
+namespace ml {
+
+// Randomized Kruskal over the odd-cell lattice: every edge is visited once in
+// a random order and opened when it joins two different trees. Gives a
+// uniform-looking texture with many short dead ends, unlike DFS/Prim.
+//
+// The order is a keyed bijection of the edge indices (a Feistel network seeded
+// from cfg.seed), so position i maps to its edge in O(1) and nothing is
+// sorted or stored per edge. Edges go in batches: workers drop the ones whose
+// ends are already connected (lock-free union-find reads with path halving),
+// then the survivors are joined in order on the calling thread. Memory is
+// 4 bytes per lattice node plus one batch; the maze depends only on the seed.
+class KruskalGenerator final : public IMazeGenerator {
+public:
+    std::string Name() const override { return "Kruskal"; }
+    void Generate(Maze& maze, const MazeGenConfig& cfg) override;
+    void GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch& scratch) override;
+    std::unique_ptr<IGenTask> Begin(const MazeGenConfig& cfg) override;
+};
+
+} // namespace ml
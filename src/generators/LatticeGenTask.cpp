@@ -0,0 +1,27 @@
+#include "generators/LatticeGenTask.h"
+
+namespace ml {
+
+LatticeGenTask::LatticeGenTask(int width, int height, uint32_t seed, LatticeCarver carver, CellPos startOdd)
+    : m_w(width), m_h(height), m_rng(seed) {
+    m_lattice.ResetForMaze(m_w, m_h);
+    m_lattice.BeginCarve(carver, m_lattice.NodeAt(startOdd));
+}
+
+float LatticeGenTask::Progress() const {
+    const int total = m_lattice.NodeCount();
+    return total > 0 ? static_cast<float>(m_lattice.CarvedNodes()) / static_cast<float>(total) : 1.f;
+}
+
+bool LatticeGenTask::Preview(Maze& out) const {
+    if (out.Width() != m_w || out.Height() != m_h) out.Resize(m_w, m_h);
+    m_lattice.Rasterize(out);
+    return true;
+}
+
+void LatticeGenTask::Finish(Maze& out) {
+    out.Resize(m_w, m_h);
+    m_lattice.Rasterize(out);
+}
+
+} // namespace ml
@@ -0,0 +1,25 @@
+#pragma once
+#include "generators/CellLattice.h"
+#include "generators/IMazeGenerator.h"
+
+namespace ml {
+
+// Time-sliced DFS/Prim: the CellLattice carvers run a budget at a time and
+// the lattice is rasterized once at the end (or for a preview).
+class LatticeGenTask final : public IGenTask {
+public:
+    LatticeGenTask(int width, int height, uint32_t seed, LatticeCarver carver, CellPos startOdd);
+
+    bool Step(long long budget) override { return m_lattice.CarveSome(m_rng, budget); }
+    float Progress() const override;
+    bool Preview(Maze& out) const override;
+    void Finish(Maze& out) override;
+
+private:
+    int m_w;
+    int m_h;
+    RNG m_rng;
+    CellLattice m_lattice;
+};
+
+} // namespace ml
@@ -1,66 +1,56 @@
 #include "generators/PrimGenerator.h"
+#include "generators/CellLattice.h"
+#include "generators/LatticeGenTask.h"
+#include "generators/TiledGeneration.h"
 #include <vector>
 
 namespace ml {
 
-static CellPos MakeOddInBounds(const Maze& m, CellPos p) {
+static CellPos MakeOddInBounds(int w, int h, CellPos p) {
     if (p.x < 1) p.x = 1;
     if (p.y < 1) p.y = 1;
-    if (p.x > m.Width() - 2) p.x = m.Width() - 2;
-    if (p.y > m.Height() - 2) p.y = m.Height() - 2;
-    if ((p.x % 2) == 0) p.x += (p.x == m.Width() - 2 ? -1 : 1);
-    if ((p.y % 2) == 0) p.y += (p.y == m.Height() - 2 ? -1 : 1);
+    if (p.x > w - 2) p.x = w - 2;
+    if (p.y > h - 2) p.y = h - 2;
+    if ((p.x % 2) == 0) p.x += (p.x == w - 2 ? -1 : 1);
+    if ((p.y % 2) == 0) p.y += (p.y == h - 2 ? -1 : 1);
     return p;
 }
 
-struct Edge {
-    CellPos from;
-    CellPos to;
-};
-
 void PrimGenerator::Generate(Maze& maze, const MazeGenConfig& cfg) {
     maze.Resize(cfg.width, cfg.height);
-    maze.FillWalls();
-
-    RNG rng(cfg.randomSeed ? RNG().NextU32() : cfg.seed);
-
-    CellPos startOdd = MakeOddInBounds(maze, cfg.start);
-    CellPos exitOdd  = MakeOddInBounds(maze, cfg.exit);
-
-    const int w = maze.Width();
-    const int h = maze.Height();
-    std::vector<uint8_t> inTree(static_cast<size_t>(w*h), 0u);
-
-    auto mark = [&](CellPos p) { inTree[static_cast<size_t>(ToIndex(p.x,p.y,w))] = 1u; };
-    auto isMarked = [&](CellPos p)->bool { return inTree[static_cast<size_t>(ToIndex(p.x,p.y,w))] != 0u; };
-
-    std::vector<Edge> frontier;
+    const size_t words = static_cast<size_t>(maze.WordsPerRow());
+    std::vector<uint64_t> rows(static_cast<size_t>(maze.Height()) * words, 0u);
+    GenScratch scratch;
+    GenerateRows(cfg, rows.data(), words, scratch);
+    maze.LoadRows(rows.data(), words);
+}
 
-    auto addFrontier = [&](CellPos p) {
-        for (auto n : maze.OddNeighbors2(p)) {
-            if (!isMarked(n)) frontier.push_back({p, n});
-        }
-    };
+void PrimGenerator::GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch& scratch) {
+    if (cfg.tiled) {
+        GenerateTiledRows(cfg, LatticeCarver::Prim, rows, stride);
+        return;
+    }
 
-    maze.SetFree(startOdd, true);
-    mark(startOdd);
-    addFrontier(startOdd);
+    const int w = GenWidth(cfg);
+    const int h = GenHeight(cfg);
+    RNG rng(cfg.randomSeed ? RNG().NextU32() : cfg.seed);
 
-    while (!frontier.empty()) {
-        int idx = rng.NextInt(0, static_cast<int>(frontier.size()) - 1);
-        Edge e = frontier[static_cast<size_t>(idx)];
-        frontier[static_cast<size_t>(idx)] = frontier.back();
-        frontier.pop_back();
+    // Every odd tile ends up carved, so start and exit (forced odd) are free.
+    CellPos startOdd = MakeOddInBounds(w, h, cfg.start);
 
-        if (isMarked(e.to)) continue;
+    CellLattice& lattice = scratch.lattice;
+    lattice.ResetForMaze(w, h);
+    lattice.CarveAll(LatticeCarver::Prim, lattice.NodeAt(startOdd), rng);
+    lattice.RasterizeRows(rows, stride, (w + 63) / 64);
+}
 
-        maze.CarvePassage(e.from, e.to);
-        mark(e.to);
-        addFrontier(e.to);
-    }
+std::unique_ptr<IGenTask> PrimGenerator::Begin(const MazeGenConfig& cfg) {
+    if (cfg.tiled) return std::make_unique<TiledGenTask>(cfg, LatticeCarver::Prim);
 
-    maze.SetFree(startOdd, true);
-    maze.SetFree(exitOdd, true);
+    const int w = GenWidth(cfg);
+    const int h = GenHeight(cfg);
+    const uint32_t seed = cfg.randomSeed ? RNG().NextU32() : cfg.seed;
+    return std::make_unique<LatticeGenTask>(w, h, seed, LatticeCarver::Prim, MakeOddInBounds(w, h, cfg.start));
 }
 
 } // namespace ml
@@ -1,64 +1,57 @@
 #include "generators/RecursiveBacktrackerGenerator.h"
+#include "generators/CellLattice.h"
+#include "generators/LatticeGenTask.h"
+#include "generators/TiledGeneration.h"
 #include <vector>
 
 namespace ml {
 
-static CellPos MakeOddInBounds(const Maze& m, CellPos p) {
+static CellPos MakeOddInBounds(int w, int h, CellPos p) {
     // clamp to inside boundary, then force odd
     if (p.x < 1) p.x = 1;
     if (p.y < 1) p.y = 1;
-    if (p.x > m.Width() - 2) p.x = m.Width() - 2;
-    if (p.y > m.Height() - 2) p.y = m.Height() - 2;
-    if ((p.x % 2) == 0) p.x += (p.x == m.Width() - 2 ? -1 : 1);
-    if ((p.y % 2) == 0) p.y += (p.y == m.Height() - 2 ? -1 : 1);
+    if (p.x > w - 2) p.x = w - 2;
+    if (p.y > h - 2) p.y = h - 2;
+    if ((p.x % 2) == 0) p.x += (p.x == w - 2 ? -1 : 1);
+    if ((p.y % 2) == 0) p.y += (p.y == h - 2 ? -1 : 1);
     return p;
 }
 
 void RecursiveBacktrackerGenerator::Generate(Maze& maze, const MazeGenConfig& cfg) {
     maze.Resize(cfg.width, cfg.height);
-    maze.FillWalls();
-
-    RNG rng(cfg.randomSeed ? RNG().NextU32() : cfg.seed);
-
-    CellPos startOdd = MakeOddInBounds(maze, cfg.start);
-    CellPos exitOdd  = MakeOddInBounds(maze, cfg.exit);
-
-    const int w = maze.Width();
-    const int h = maze.Height();
-    std::vector<uint8_t> visited(static_cast<size_t>(w*h), 0u);
-
-    auto markVisited = [&](CellPos p) { visited[static_cast<size_t>(ToIndex(p.x,p.y,w))] = 1u; };
-    auto isVisited = [&](CellPos p) -> bool { return visited[static_cast<size_t>(ToIndex(p.x,p.y,w))] != 0u; };
+    const size_t words = static_cast<size_t>(maze.WordsPerRow());
+    std::vector<uint64_t> rows(static_cast<size_t>(maze.Height()) * words, 0u);
+    GenScratch scratch;
+    GenerateRows(cfg, rows.data(), words, scratch);
+    maze.LoadRows(rows.data(), words);
+}
 
-    std::vector<CellPos> stack;
-    stack.push_back(startOdd);
-    markVisited(startOdd);
-    maze.SetFree(startOdd, true);
+void RecursiveBacktrackerGenerator::GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch& scratch) {
+    if (cfg.tiled) {
+        GenerateTiledRows(cfg, LatticeCarver::Backtracker, rows, stride);
+        return;
+    }
 
-    while (!stack.empty()) {
-        CellPos cur = stack.back();
-        auto neigh = maze.OddNeighbors2(cur);
+    const int w = GenWidth(cfg);
+    const int h = GenHeight(cfg);
+    RNG rng(cfg.randomSeed ? RNG().NextU32() : cfg.seed);
 
-        // collect unvisited
-        std::vector<CellPos> cand;
-        cand.reserve(neigh.size());
-        for (auto n : neigh) if (!isVisited(n)) cand.push_back(n);
+    // Every odd tile ends up carved, so start and exit (forced odd) are free.
+    CellPos startOdd = MakeOddInBounds(w, h, cfg.start);
 
-        if (cand.empty()) {
-            stack.pop_back();
-            continue;
-        }
+    CellLattice& lattice = scratch.lattice;
+    lattice.ResetForMaze(w, h);
+    lattice.CarveAll(LatticeCarver::Backtracker, lattice.NodeAt(startOdd), rng);
+    lattice.RasterizeRows(rows, stride, (w + 63) / 64);
+}
 
-        int idx = rng.NextInt(0, static_cast<int>(cand.size()) - 1);
-        CellPos nxt = cand[static_cast<size_t>(idx)];
-        maze.CarvePassage(cur, nxt);
-        markVisited(nxt);
-        stack.push_back(nxt);
-    }
+std::unique_ptr<IGenTask> RecursiveBacktrackerGenerator::Begin(const MazeGenConfig& cfg) {
+    if (cfg.tiled) return std::make_unique<TiledGenTask>(cfg, LatticeCarver::Backtracker);
 
-    // Ensure start/exit are open and connected via carved graph (they are odd nodes, so path exists).
-    maze.SetFree(startOdd, true);
-    maze.SetFree(exitOdd, true);
+    const int w = GenWidth(cfg);
+    const int h = GenHeight(cfg);
+    const uint32_t seed = cfg.randomSeed ? RNG().NextU32() : cfg.seed;
+    return std::make_unique<LatticeGenTask>(w, h, seed, LatticeCarver::Backtracker, MakeOddInBounds(w, h, cfg.start));
 }
 
 } // namespace ml
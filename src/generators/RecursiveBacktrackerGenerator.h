@@ -7,6 +7,8 @@ class RecursiveBacktrackerGenerator final : public IMazeGenerator {
 public:
     std::string Name() const override { return "DFS (Recursive Backtracker)"; }
     void Generate(Maze& maze, const MazeGenConfig& cfg) override;
+    void GenerateRows(const MazeGenConfig& cfg, uint64_t* rows, size_t stride, GenScratch& scratch) override;
+    std::unique_ptr<IGenTask> Begin(const MazeGenConfig& cfg) override;
 };
 
 } // namespace ml
@@ -0,0 +1,164 @@
+#include "generators/TiledGeneration.h"
+#include "core/DisjointSet.h"
+#include "core/ThreadPool.h"
+#include "generators/CellLattice.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace ml {
+
+static constexpr int kTileCells = 32; // lattice cells per tile side (64 maze tiles)
+
+namespace {
+
+// Tile grid of a config; every tile is a 32x32-cell lattice except at the far edges.
+struct TilePlan {
+    int cw; // lattice cells per row
+    int ch;
+    int tilesX;
+    int tilesY;
+    RNG base;
+
+    TilePlan(const MazeGenConfig& cfg, const RNG& seeded)
+        : cw((GenWidth(cfg) - 1) / 2), ch((GenHeight(cfg) - 1) / 2),
+          tilesX((cw + kTileCells - 1) / kTileCells), tilesY((ch + kTileCells - 1) / kTileCells),
+          base(seeded) {}
+
+    int Count() const noexcept { return tilesX * tilesY; }
+    int TileW(int tx) const noexcept { return std::min(kTileCells, cw - tx * kTileCells); }
+    int TileH(int ty) const noexcept { return std::min(kTileCells, ch - ty * kTileCells); }
+};
+
+// Tile t draws from BaseRng(cfg).Split(t), the stitch from BaseRng(cfg) itself.
+RNG BaseRng(const MazeGenConfig& cfg) { return RNG(cfg.randomSeed ? RNG().NextU64() : cfg.seed); }
+
+// Carves tiles [first, last) and rasterizes each into its own word column.
+void CarveTiles(const TilePlan& plan, LatticeCarver carver, uint64_t* rows, size_t stride, int first, int last,
+                std::vector<CellLattice>& scratch, int threads) {
+    // Tiles are carved on a per-thread lattice and rasterized into their own
+    // word column; the lattice buffers are reused from tile to tile.
+    ThreadPool& pool = ThreadPool::Shared();
+    scratch.resize(static_cast<size_t>(pool.Size()));
+    pool.ParallelFor(last - first, [&](int i, int slot) {
+        const int tile = first + i;
+        const int tx = tile % plan.tilesX;
+        const int ty = tile / plan.tilesX;
+        const int tw = plan.TileW(tx);
+        CellLattice& lattice = scratch[static_cast<size_t>(slot)];
+        lattice.Reset(tw, plan.TileH(ty));
+
+        RNG rng = plan.base.Split(static_cast<uint64_t>(tile));
+        const int start = static_cast<int>(rng.NextBelow(static_cast<uint32_t>(tw * plan.TileH(ty))));
+        const int startNode = lattice.Node(start % tw, start / tw);
+        lattice.CarveAll(carver, startNode, rng);
+
+        uint64_t* window = rows + static_cast<size_t>(ty) * 2 * kTileCells * stride + static_cast<size_t>(tx);
+        lattice.RasterizeRows(window, stride, 1);
+    }, threads);
+}
+
+void StitchTiles(const TilePlan& plan, uint64_t* rows, size_t stride) {
+    // Stitch: Kruskal over tile adjacencies in random order, one opening per
+    // accepted edge at a random lattice position along the shared border.
+    const int tilesX = plan.tilesX;
+    const int tilesY = plan.tilesY;
+    struct TileEdge { int a, b; bool right; };
+    std::vector<TileEdge> edges;
+    edges.reserve(static_cast<size_t>(tilesX * tilesY * 2));
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            const int t = ty * tilesX + tx;
+            if (tx + 1 < tilesX) edges.push_back({t, t + 1, true});
+            if (ty + 1 < tilesY) edges.push_back({t, t + tilesX, false});
+        }
+    }
+
+    RNG stitch = plan.base;
+    stitch.Shuffle(edges.begin(), edges.end());
+
+    std::vector<int> parent(static_cast<size_t>(tilesX * tilesY));
+    std::iota(parent.begin(), parent.end(), 0);
+    for (const TileEdge& e : edges) {
+        const int ra = FindRoot(parent, e.a);
+        const int rb = FindRoot(parent, e.b);
+        if (ra == rb) continue;
+        parent[static_cast<size_t>(std::max(ra, rb))] = std::min(ra, rb);
+
+        const int tx = e.a % tilesX;
+        const int ty = e.a / tilesX;
+        if (e.right) {
+            // wall column x = 64*(tx+1), bit 0 of word tx+1
+            const int j = static_cast<int>(stitch.NextBelow(static_cast<uint32_t>(plan.TileH(ty))));
+            const size_t y = static_cast<size_t>(ty * 2 * kTileCells + 2 * j + 1);
+            rows[y * stride + static_cast<size_t>(tx + 1)] |= 1u;
+        } else {
+            const int i = static_cast<int>(stitch.NextBelow(static_cast<uint32_t>(plan.TileW(tx))));
+            const size_t y = static_cast<size_t>((ty + 1) * 2 * kTileCells);
+            rows[y * stride + static_cast<size_t>(tx)] |= uint64_t{1} << (2 * i + 1);
+        }
+    }
+}
+
+} // namespace
+
+void GenerateTiledRows(const MazeGenConfig& cfg, LatticeCarver carver, uint64_t* rows, size_t stride) {
+    const TilePlan plan(cfg, BaseRng(cfg));
+    std::vector<CellLattice> scratch;
+    CarveTiles(plan, carver, rows, stride, 0, plan.Count(), scratch, cfg.threads);
+    StitchTiles(plan, rows, stride);
+}
+
+void GenerateTiledMaze(Maze& maze, const MazeGenConfig& cfg, LatticeCarver carver) {
+    maze.Resize(cfg.width, cfg.height);
+    const size_t words = static_cast<size_t>(maze.WordsPerRow());
+    std::vector<uint64_t> rows(static_cast<size_t>(maze.Height()) * words, 0u);
+    GenerateTiledRows(cfg, carver, rows.data(), words);
+    maze.LoadRows(rows.data(), words);
+}
+
+TiledGenTask::TiledGenTask(const MazeGenConfig& cfg, LatticeCarver carver)
+    : m_cfg(cfg), m_carver(carver), m_base(BaseRng(cfg)), m_w(GenWidth(cfg)), m_h(GenHeight(cfg)),
+      m_words(static_cast<size_t>((m_w + 63) / 64)), m_rows(m_words * static_cast<size_t>(m_h), 0u),
+      m_tiles(TilePlan(cfg, m_base).Count()) {}
+
+bool TiledGenTask::Step(long long budget) {
+    if (m_next < m_tiles) {
+        // about one unit per lattice cell, so a tile is ~1024
+        const long long perTile = static_cast<long long>(kTileCells) * kTileCells;
+        const int count = static_cast<int>(std::clamp<long long>(budget / perTile, 1, m_tiles - m_next));
+        const TilePlan plan(m_cfg, m_base);
+        CarveTiles(plan, m_carver, m_rows.data(), m_words, m_next, m_next + count, m_scratch, m_cfg.threads);
+        m_next += count;
+        return false;
+    }
+    if (!m_stitched) {
+        StitchTiles(TilePlan(m_cfg, m_base), m_rows.data(), m_words);
+        m_stitched = true;
+        m_maze.Resize(m_w, m_h);
+        return false;
+    }
+    if (m_loaded < m_h) {
+        const int rows = static_cast<int>(std::clamp<long long>(budget / static_cast<long long>(m_words), 1, m_h));
+        m_loaded = m_maze.LoadRowsFrom(m_rows.data(), m_words, m_loaded, rows);
+    }
+    return m_loaded == m_h;
+}
+
+float TiledGenTask::Progress() const {
+    // carving 90%, loading the stitched rows 10%
+    if (m_stitched) return 0.9f + 0.1f * static_cast<float>(m_loaded) / static_cast<float>(m_h);
+    return m_tiles > 0 ? 0.9f * static_cast<float>(m_next) / static_cast<float>(m_tiles) : 0.f;
+}
+
+bool TiledGenTask::Preview(Maze& out) const {
+    if (out.Width() != m_w || out.Height() != m_h) out.Resize(m_w, m_h);
+    out.LoadRows(m_rows.data(), m_words);
+    return true;
+}
+
+void TiledGenTask::Finish(Maze& out) {
+    out = std::move(m_maze);
+}
+
+} // namespace ml
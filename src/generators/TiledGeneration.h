@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "generators/CellLattice.h"
+#include "generators/IMazeGenerator.h"
+
+namespace ml {
+
+// Tile-parallel perfect maze over the odd-cell lattice (MazeGenConfig::tiled).
+// The lattice is cut into 32x32-cell tiles, i.e. 64x64 maze tiles that each
+// own one row word per row, so workers write disjoint words. Tile t is carved
+// from RNG(seed).Split(t); tiles are then joined by a random spanning tree
+// over tile adjacencies (one opening per tree edge) drawn from RNG(seed).
+// The maze depends only on the seed, never on the thread count.
+void GenerateTiledMaze(Maze& maze, const MazeGenConfig& cfg, LatticeCarver carver);
+// Same maze as bit-packed free rows (see IMazeGenerator::GenerateRows).
+void GenerateTiledRows(const MazeGenConfig& cfg, LatticeCarver carver, uint64_t* rows, size_t stride);
+
+// The same maze in slices: each Step() carves a range of tiles (in parallel),
+// the step after the last tile stitches them, and the rows then go into the
+// maze a band at a time.
+class TiledGenTask final : public IGenTask {
+public:
+    TiledGenTask(const MazeGenConfig& cfg, LatticeCarver carver);
+
+    bool Step(long long budget) override;
+    float Progress() const override;
+    bool Preview(Maze& out) const override;
+    void Finish(Maze& out) override;
+
+private:
+    MazeGenConfig m_cfg;
+    LatticeCarver m_carver;
+    RNG m_base; // resolved once, so a random seed stays the same across slices
+    int m_w;
+    int m_h;
+    size_t m_words;
+    std::vector<uint64_t> m_rows;
+    std::vector<CellLattice> m_scratch; // one per pool thread
+    int m_tiles;
+    int m_next{0};   // next tile to carve
+    bool m_stitched{false};
+    int m_loaded{0}; // rows loaded into m_maze
+    Maze m_maze;
+};
+
+} // namespace ml
@@ -1,83 +1,56 @@
 #include "pathfinding/AStarPathfinder.h"
-#include <queue>
-#include <limits>
-#include <cmath>
+#include "core/MazeFile.h"
+#include <algorithm>
 
 namespace ml {
 
-static int Manhattan(CellPos a, CellPos b) {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
-}
-
-struct PQNode {
-    int f;
-    int g;
-    CellPos pos;
-};
-
-struct PQCmp {
-    bool operator()(const PQNode& a, const PQNode& b) const noexcept {
-        // min-heap via reverse
-        if (a.f != b.f) return a.f > b.f;
-        return a.g > b.g;
-    }
-};
-
-PathResult AStarPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal) {
+template <MazeGrid Grid>
+static PathResult AStarSearch(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
     PathResult res;
-    const int w = maze.Width();
-    const int h = maze.Height();
-    auto idx = [&](CellPos p) { return ToIndex(p.x, p.y, w); };
+    const CellLayout& layout = maze.Layout();
 
-    if (!maze.InBounds(start) || !maze.InBounds(goal) || maze.IsWall(start) || maze.IsWall(goal)) {
+    if (!SearchableEnds(maze, start, goal)) {
         res.found = false;
         return res;
     }
 
-    const int N = w*h;
-    const int INF = std::numeric_limits<int>::max() / 4;
+    ws.Begin(layout.Count());
 
-    std::vector<int> prev(static_cast<size_t>(N), -1);
-    std::vector<int> gScore(static_cast<size_t>(N), INF);
-    std::vector<uint8_t> closed(static_cast<size_t>(N), 0u);
+    // unit costs: f = g + h is a small integer, each cell queued at most once
+    BucketQueue<int>& open = ws.Buckets();
+    open.Reset(static_cast<size_t>(layout.Count()));
+    const int si = layout.Index(start);
+    const int gi = layout.Index(goal);
+    ws.Reach(si, -1, 0);
+    open.Push(si, Manhattan(start, goal));
 
-    std::priority_queue<PQNode, std::vector<PQNode>, PQCmp> open;
-    gScore[static_cast<size_t>(idx(start))] = 0;
-    open.push({Manhattan(start, goal), 0, start});
-
-    while (!open.empty()) {
-        PQNode curN = open.top();
-        open.pop();
-        CellPos cur = curN.pos;
-        int ci = idx(cur);
-        if (closed[static_cast<size_t>(ci)]) continue;
-        closed[static_cast<size_t>(ci)] = 1u;
+    while (!open.Empty()) {
+        const int ci = open.Pop();
+        ws.Close(ci);
         res.expandedNodes++;
 
-        if (cur == goal) {
+        if (ci == gi) {
             res.found = true;
             std::vector<CellPos> path;
             int curi = ci;
             while (curi != -1) {
-                path.push_back({curi % w, curi / w});
-                curi = prev[static_cast<size_t>(curi)];
+                path.push_back(layout.Pos(curi));
+                curi = ws.Prev(curi);
             }
             std::reverse(path.begin(), path.end());
             res.path = std::move(path);
             return res;
         }
 
-        for (Dir d : kDirs) {
-            CellPos nxt = maze.Step(cur, d);
-            if (!maze.InBounds(nxt) || maze.IsWall(nxt)) continue;
-            int ni = idx(nxt);
-            if (closed[static_cast<size_t>(ni)]) continue;
-            int tentativeG = gScore[static_cast<size_t>(ci)] + 1;
-            if (tentativeG < gScore[static_cast<size_t>(ni)]) {
-                gScore[static_cast<size_t>(ni)] = tentativeG;
-                prev[static_cast<size_t>(ni)] = ci;
-                int f = tentativeG + Manhattan(nxt, goal);
-                open.push({f, tentativeG, nxt});
+        const CellPos cur = layout.Pos(ci);
+        for (uint8_t dirs = maze.OpenDirsAt(ci); dirs; dirs &= dirs - 1) {
+            const Dir d = FirstDir(dirs);
+            const int ni = layout.Step(ci, d);
+            if (ws.Closed(ni)) continue;
+            const int tentativeG = ws.G(ci) + 1;
+            if (tentativeG < ws.G(ni)) {
+                ws.Reach(ni, ci, tentativeG);
+                open.Push(ni, tentativeG + Manhattan(maze.Step(cur, d), goal));
             }
         }
     }
@@ -86,4 +59,12 @@ PathResult AStarPathfinder::FindPath(const Maze& maze, CellPos start, CellPos go
     return res;
 }
 
+PathResult AStarPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return AStarSearch(maze, start, goal, ws);
+}
+
+PathResult AStarPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return AStarSearch(view, start, goal, ws);
+}
+
 } // namespace ml
@@ -6,7 +6,15 @@ namespace ml {
 class AStarPathfinder final : public IPathfinder {
 public:
     std::string Name() const override { return "A*"; }
-    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override;
+    // The 3-argument form runs on the pathfinder's own workspace.
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override {
+        return FindPath(maze, start, goal, m_workspace);
+    }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+
+private:
+    SearchWorkspace m_workspace;
 };
 
 } // namespace ml
@@ -1,56 +1,53 @@
 #include "pathfinding/BFSPathfinder.h"
-#include <queue>
+#include "core/MazeFile.h"
+#include <algorithm>
 
 namespace ml {
 
-PathResult BFSPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal) {
+template <MazeGrid Grid>
+static PathResult BfsSearch(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
     PathResult res;
-    const int w = maze.Width();
-    const int h = maze.Height();
+    const CellLayout& layout = maze.Layout();
 
-    auto idx = [&](CellPos p) { return ToIndex(p.x, p.y, w); };
-
-    std::vector<int> prev(static_cast<size_t>(w*h), -1);
-    std::vector<uint8_t> vis(static_cast<size_t>(w*h), 0u);
-
-    if (!maze.InBounds(start) || !maze.InBounds(goal) || maze.IsWall(start) || maze.IsWall(goal)) {
+    if (!SearchableEnds(maze, start, goal)) {
         res.found = false;
         return res;
     }
 
-    std::queue<CellPos> q;
-    q.push(start);
-    vis[static_cast<size_t>(idx(start))] = 1u;
+    ws.Begin(layout.Count());
+
+    const int si = layout.Index(start);
+    const int gi = layout.Index(goal);
+
+    // FIFO of padded indices; the wall ring keeps every neighbour index in range
+    std::vector<int>& q = ws.Queue();
+    size_t head = 0;
+    q.push_back(si);
+    ws.Reach(si, -1, 0);
 
-    while (!q.empty()) {
-        CellPos cur = q.front();
-        q.pop();
+    while (head < q.size()) {
+        const int ci = q[head++];
         res.expandedNodes++;
 
-        if (cur == goal) {
+        if (ci == gi) {
             res.found = true;
             // reconstruct
             std::vector<CellPos> path;
-            int curi = idx(cur);
+            int curi = ci;
             while (curi != -1) {
-                int x = curi % w;
-                int y = curi / w;
-                path.push_back({x,y});
-                curi = prev[static_cast<size_t>(curi)];
+                path.push_back(layout.Pos(curi));
+                curi = ws.Prev(curi);
             }
             std::reverse(path.begin(), path.end());
             res.path = std::move(path);
             return res;
         }
 
-        for (Dir d : kDirs) {
-            CellPos nxt = maze.Step(cur, d);
-            if (!maze.InBounds(nxt) || maze.IsWall(nxt)) continue;
-            int ni = idx(nxt);
-            if (vis[static_cast<size_t>(ni)]) continue;
-            vis[static_cast<size_t>(ni)] = 1u;
-            prev[static_cast<size_t>(ni)] = idx(cur);
-            q.push(nxt);
+        for (uint8_t dirs = maze.OpenDirsAt(ci); dirs; dirs &= dirs - 1) {
+            const int ni = layout.Step(ci, FirstDir(dirs));
+            if (ws.Seen(ni)) continue;
+            ws.Reach(ni, ci, 0);
+            q.push_back(ni);
         }
     }
 
@@ -58,4 +55,12 @@ PathResult BFSPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal
     return res;
 }
 
+PathResult BFSPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return BfsSearch(maze, start, goal, ws);
+}
+
+PathResult BFSPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return BfsSearch(view, start, goal, ws);
+}
+
 } // namespace ml
@@ -0,0 +1,74 @@
+#include "pathfinding/BatchPathfinding.h"
+#include "core/MazeFile.h"
+#include "core/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace ml {
+
+namespace {
+
+constexpr int kQueriesPerTask = 64; // short queries: keep index hand-out off the profile
+
+template <MazeGrid Grid>
+PathBatchStats RunBatch(IPathfinder& pathfinder, const Grid& maze, std::span<const PathQuery> queries,
+                        std::span<PathResult> results, int maxThreads) {
+    const auto t0 = std::chrono::steady_clock::now();
+
+    const bool keep = !results.empty();
+    const int count = static_cast<int>(keep ? std::min(queries.size(), results.size()) : queries.size());
+    const int tasks = (count + kQueriesPerTask - 1) / kQueriesPerTask;
+    ThreadPool& pool = ThreadPool::Shared();
+    const int threads = std::min(maxThreads > 0 ? std::min(maxThreads, pool.Size()) : pool.Size(), std::max(tasks, 1));
+
+    // lazily built shared state (caches, the maze fingerprint) must exist before
+    // the workers start reading it
+    maze.Fingerprint();
+    pathfinder.Prepare(maze);
+
+    std::vector<SearchWorkspace> workspaces(static_cast<size_t>(pool.Size()));
+    std::vector<PathResult> scratch(keep ? 0u : static_cast<size_t>(pool.Size()));
+    std::vector<uint64_t> expanded(static_cast<size_t>(pool.Size()), 0u);
+    std::vector<uint64_t> tiles(static_cast<size_t>(pool.Size()), 0u);
+    std::vector<int> found(static_cast<size_t>(pool.Size()), 0);
+    pool.ParallelFor(tasks, [&](int task, int slot) {
+        const size_t s = static_cast<size_t>(slot);
+        const int end = std::min(count, (task + 1) * kQueriesPerTask);
+        for (int i = task * kQueriesPerTask; i < end; ++i) {
+            const PathQuery& q = queries[static_cast<size_t>(i)];
+            PathResult& r = keep ? results[static_cast<size_t>(i)] : scratch[s];
+            r = pathfinder.FindPath(maze, q.start, q.goal, workspaces[s]);
+            expanded[s] += static_cast<uint64_t>(r.expandedNodes);
+            tiles[s] += r.path.size();
+            found[s] += r.found ? 1 : 0;
+        }
+    }, threads);
+
+    const auto t1 = std::chrono::steady_clock::now();
+    PathBatchStats stats;
+    stats.pathfinder = pathfinder.Name();
+    stats.queries = count;
+    for (size_t s = 0; s < expanded.size(); ++s) {
+        stats.expandedNodes += expanded[s];
+        stats.pathTiles += tiles[s];
+        stats.found += found[s];
+    }
+    stats.threads = threads;
+    stats.seconds = std::chrono::duration<double>(t1 - t0).count();
+    return stats;
+}
+
+} // namespace
+
+PathBatchStats FindPaths(IPathfinder& pathfinder, const Maze& maze, std::span<const PathQuery> queries,
+                         std::span<PathResult> results, int maxThreads) {
+    return RunBatch(pathfinder, maze, queries, results, maxThreads);
+}
+
+PathBatchStats FindPaths(IPathfinder& pathfinder, const MazeView& view, std::span<const PathQuery> queries,
+                         std::span<PathResult> results, int maxThreads) {
+    return RunBatch(pathfinder, view, queries, results, maxThreads);
+}
+
+} // namespace ml
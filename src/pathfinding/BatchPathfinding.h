@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include "pathfinding/IPathfinder.h"
+
+namespace ml {
+
+struct PathQuery {
+    CellPos start;
+    CellPos goal;
+};
+
+struct PathBatchStats {
+    std::string pathfinder;
+    int queries{0};
+    int found{0};
+    uint64_t expandedNodes{0}; // summed over all queries
+    uint64_t pathTiles{0};     // tiles on the found paths, summed
+    int threads{0};
+    double seconds{0.0};
+
+    double QueriesPerSecond() const noexcept { return seconds > 0.0 ? queries / seconds : 0.0; }
+    double ExpandedPerSecond() const noexcept { return seconds > 0.0 ? static_cast<double>(expandedNodes) / seconds : 0.0; }
+};
+
+// Answers queries[i] into results[i] (results must be at least as long) on the
+// shared ThreadPool, at most maxThreads workers (<= 0: all). With empty results
+// every query is answered but only the stats are kept, so throughput runs over
+// many long paths stay small. The maze is shared read-only and the pathfinder
+// is Prepare()d once on the calling thread; each worker runs the 4-argument
+// FindPath on its own SearchWorkspace. Results do not depend on the thread
+// count. The MazeView form answers straight from a mapped .mlzb file.
+PathBatchStats FindPaths(IPathfinder& pathfinder, const Maze& maze, std::span<const PathQuery> queries,
+                         std::span<PathResult> results, int maxThreads = 0);
+PathBatchStats FindPaths(IPathfinder& pathfinder, const MazeView& view, std::span<const PathQuery> queries,
+                         std::span<PathResult> results, int maxThreads = 0);
+
+} // namespace ml
@@ -0,0 +1,103 @@
+#include "pathfinding/BidirectionalAStarPathfinder.h"
+#include "core/MazeFile.h"
+#include <algorithm>
+
+namespace ml {
+
+// Twice the forward potential (M(v, goal) - M(v, start)) / 2; the backward
+// side uses its negation. Both are consistent and the pair is balanced, so
+// keys stay integers when g is doubled too.
+static int Potential2(CellPos v, CellPos from, CellPos to) {
+    return Manhattan(v, to) - Manhattan(v, from);
+}
+
+template <MazeGrid Grid>
+static PathResult BidirectionalAStarSearch(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    PathResult res;
+    const CellLayout& layout = maze.Layout();
+
+    if (!SearchableEnds(maze, start, goal)) {
+        res.found = false;
+        return res;
+    }
+
+    const int si = layout.Index(start);
+    const int gi = layout.Index(goal);
+    if (si == gi) {
+        res.found = true;
+        res.expandedNodes = 1;
+        res.path.push_back(start);
+        return res;
+    }
+
+    // Keys are 2g + Potential2 + d, d = M(start, goal) >= |Potential2|, so the
+    // bucket queues see non-negative integers. Equal keys pop newest first,
+    // which keeps open areas from being swept breadth-first.
+    const int d = Manhattan(start, goal);
+    SearchWorkspace* sides[2] = {&ws, &ws.Backward()};
+    const CellPos ends[2][2] = {{start, goal}, {goal, start}}; // {own end, other end}
+    BucketQueue<int>* open[2] = {&sides[0]->Buckets(), &sides[1]->Buckets()};
+    for (int s = 0; s < 2; ++s) {
+        sides[s]->Begin(layout.Count());
+        open[s]->Reset(static_cast<size_t>(layout.Count()));
+    }
+    sides[0]->Reach(si, -1, 0);
+    sides[1]->Reach(gi, -1, 0);
+    open[0]->Push(si, Potential2(start, start, goal) + d);
+    open[1]->Push(gi, Potential2(goal, goal, start) + d);
+
+    int mu = SearchWorkspace::kInf;
+    int meet = -1;
+    while (!open[0]->Empty() && !open[1]->Empty()) {
+        // a shorter path would have open nodes u, w with fF(u) + fB(w) <= 2 * length
+        if (mu < SearchWorkspace::kInf && open[0]->TopPriority() + open[1]->TopPriority() - 2 * d >= 2 * mu) break;
+
+        const int s = open[0]->Size() <= open[1]->Size() ? 0 : 1;
+        SearchWorkspace& self = *sides[s];
+        const SearchWorkspace& other = *sides[1 - s];
+        const int ci = open[s]->Pop();
+        const CellPos cur = layout.Pos(ci);
+        self.Close(ci);
+        res.expandedNodes++;
+
+        for (uint8_t dirs = maze.OpenDirsAt(ci); dirs; dirs &= dirs - 1) {
+            const Dir dir = FirstDir(dirs);
+            const int ni = layout.Step(ci, dir);
+            if (self.Closed(ni)) continue;
+            const int tentativeG = self.G(ci) + 1;
+            if (tentativeG < self.G(ni)) {
+                self.Reach(ni, ci, tentativeG);
+                const CellPos nxt = maze.Step(cur, dir);
+                open[s]->Push(ni, 2 * tentativeG + Potential2(nxt, ends[s][0], ends[s][1]) + d);
+                if (other.Seen(ni) && tentativeG + other.G(ni) < mu) {
+                    mu = tentativeG + other.G(ni);
+                    meet = ni;
+                }
+            }
+        }
+    }
+
+    if (meet < 0) {
+        res.found = false;
+        return res;
+    }
+
+    // start side back from the meeting node, then the goal side forward
+    res.found = true;
+    std::vector<CellPos> path;
+    for (int i = meet; i != -1; i = sides[0]->Prev(i)) path.push_back(layout.Pos(i));
+    std::reverse(path.begin(), path.end());
+    for (int i = sides[1]->Prev(meet); i != -1; i = sides[1]->Prev(i)) path.push_back(layout.Pos(i));
+    res.path = std::move(path);
+    return res;
+}
+
+PathResult BidirectionalAStarPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return BidirectionalAStarSearch(maze, start, goal, ws);
+}
+
+PathResult BidirectionalAStarPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return BidirectionalAStarSearch(view, start, goal, ws);
+}
+
+} // namespace ml
@@ -0,0 +1,26 @@
+#pragma once
+#include "pathfinding/IPathfinder.h"
+
+namespace ml {
+
+// A* from both ends with balanced potentials: the start side uses
+// (M(v, goal) - M(v, start)) / 2 and the goal side its negation (M = Manhattan
+// distance), and the side with the smaller open list goes next. mu is the best
+// joined path seen so far; the search stops once the two smallest keys add up
+// to 2 * mu, as any shorter path would still have open nodes on both sides
+// whose keys sum to less. The result is a shortest path.
+class BidirectionalAStarPathfinder final : public IPathfinder {
+public:
+    std::string Name() const override { return "Bidirectional A*"; }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override {
+        return FindPath(maze, start, goal, m_workspace);
+    }
+    // Uses ws for the start side and ws.Backward() for the goal side.
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+
+private:
+    SearchWorkspace m_workspace;
+};
+
+} // namespace ml
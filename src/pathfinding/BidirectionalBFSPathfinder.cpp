@@ -0,0 +1,86 @@
+#include "pathfinding/BidirectionalBFSPathfinder.h"
+#include "core/MazeFile.h"
+#include <algorithm>
+
+namespace ml {
+
+template <MazeGrid Grid>
+static PathResult BidirectionalBfsSearch(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    PathResult res;
+    const CellLayout& layout = maze.Layout();
+
+    if (!SearchableEnds(maze, start, goal)) {
+        res.found = false;
+        return res;
+    }
+
+    const int si = layout.Index(start);
+    const int gi = layout.Index(goal);
+    if (si == gi) {
+        res.found = true;
+        res.expandedNodes = 1;
+        res.path.push_back(start);
+        return res;
+    }
+
+    SearchWorkspace* sides[2] = {&ws, &ws.Backward()};
+    sides[0]->Begin(layout.Count());
+    sides[1]->Begin(layout.Count());
+    sides[0]->Reach(si, -1, 0);
+    sides[1]->Reach(gi, -1, 0);
+    sides[0]->Queue().push_back(si);
+    sides[1]->Queue().push_back(gi);
+    size_t heads[2] = {0, 0};
+
+    int best = SearchWorkspace::kInf;
+    int meet = -1;
+    while (heads[0] < sides[0]->Queue().size() && heads[1] < sides[1]->Queue().size()) {
+        const int s = (sides[0]->Queue().size() - heads[0] <= sides[1]->Queue().size() - heads[1]) ? 0 : 1;
+        SearchWorkspace& self = *sides[s];
+        const SearchWorkspace& other = *sides[1 - s];
+        std::vector<int>& q = self.Queue();
+
+        // one whole layer; q may grow meanwhile
+        const size_t layerEnd = q.size();
+        for (size_t& head = heads[s]; head < layerEnd; ++head) {
+            const int ci = q[head];
+            const int ng = self.G(ci) + 1;
+            res.expandedNodes++;
+            for (uint8_t dirs = maze.OpenDirsAt(ci); dirs; dirs &= dirs - 1) {
+                const int ni = layout.Step(ci, FirstDir(dirs));
+                if (self.Seen(ni)) continue;
+                self.Reach(ni, ci, ng);
+                q.push_back(ni);
+                if (other.Seen(ni) && ng + other.G(ni) < best) {
+                    best = ng + other.G(ni);
+                    meet = ni;
+                }
+            }
+        }
+        if (meet >= 0) break;
+    }
+
+    if (meet < 0) {
+        res.found = false;
+        return res;
+    }
+
+    // start side back from the meeting node, then the goal side forward
+    res.found = true;
+    std::vector<CellPos> path;
+    for (int i = meet; i != -1; i = sides[0]->Prev(i)) path.push_back(layout.Pos(i));
+    std::reverse(path.begin(), path.end());
+    for (int i = sides[1]->Prev(meet); i != -1; i = sides[1]->Prev(i)) path.push_back(layout.Pos(i));
+    res.path = std::move(path);
+    return res;
+}
+
+PathResult BidirectionalBFSPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return BidirectionalBfsSearch(maze, start, goal, ws);
+}
+
+PathResult BidirectionalBFSPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return BidirectionalBfsSearch(view, start, goal, ws);
+}
+
+} // namespace ml
@@ -0,0 +1,25 @@
+#pragma once
+#include "pathfinding/IPathfinder.h"
+
+namespace ml {
+
+// BFS from both ends. Each round expands one whole layer of the side with the
+// smaller frontier; the round in which the searches first meet is finished and
+// the shortest joined path kept, so the result is a shortest path. Both
+// frontiers stay about half the solution length deep, which on mazes with
+// start and exit in opposite corners roughly halves the expanded nodes.
+class BidirectionalBFSPathfinder final : public IPathfinder {
+public:
+    std::string Name() const override { return "Bidirectional BFS"; }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override {
+        return FindPath(maze, start, goal, m_workspace);
+    }
+    // Uses ws for the start side and ws.Backward() for the goal side.
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+
+private:
+    SearchWorkspace m_workspace;
+};
+
+} // namespace ml
@@ -0,0 +1,154 @@
+#include "pathfinding/ClusterGraph.h"
+#include "core/MazeFile.h"
+#include "core/ThreadPool.h"
+#include <algorithm>
+
+namespace ml {
+
+namespace {
+
+bool RowOrder(CellPos a, CellPos b) { return a.y != b.y ? a.y < b.y : a.x < b.x; }
+
+} // namespace
+
+ClusterGraph::Rect ClusterGraph::ClusterRect(int cluster) const noexcept {
+    const int cx = cluster % m_cols;
+    const int cy = cluster / m_cols;
+    return {cx * m_size, cy * m_size, std::min(m_w, (cx + 1) * m_size), std::min(m_h, (cy + 1) * m_size)};
+}
+
+ClusterGraph::Rect ClusterGraph::SpanRect(int a, int b) const noexcept {
+    const Rect ra = ClusterRect(a);
+    const Rect rb = ClusterRect(b);
+    return {std::min(ra.x0, rb.x0), std::min(ra.y0, rb.y0), std::max(ra.x1, rb.x1), std::max(ra.y1, rb.y1)};
+}
+
+template <MazeGrid Grid>
+void ClusterGraph::RectBfs(const Grid& maze, const Rect& r, CellPos from, std::vector<int>& dist, std::vector<int>& queue) {
+    const int rw = r.Width();
+    dist.assign(static_cast<size_t>(rw * r.Height()), kUnreached);
+    queue.clear();
+    if (!r.Contains(from) || !maze.IsFree(from)) return;
+
+    // queue holds local indices (y - y0) * width + (x - x0)
+    const int start = (from.y - r.y0) * rw + (from.x - r.x0);
+    dist[static_cast<size_t>(start)] = 0;
+    queue.push_back(start);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int li = queue[head];
+        const CellPos p{r.x0 + li % rw, r.y0 + li / rw};
+        const int nd = dist[static_cast<size_t>(li)] + 1;
+        for (uint8_t dirs = maze.OpenDirs(p); dirs; dirs &= dirs - 1) {
+            const DirDelta dd = Delta(FirstDir(dirs));
+            const CellPos n{p.x + dd.dx, p.y + dd.dy};
+            if (!r.Contains(n)) continue;
+            const int ni = li + dd.dy * rw + dd.dx;
+            if (dist[static_cast<size_t>(ni)] != kUnreached) continue;
+            dist[static_cast<size_t>(ni)] = nd;
+            queue.push_back(ni);
+        }
+    }
+}
+
+template <MazeGrid Grid>
+void ClusterGraph::Build(const Grid& maze, int clusterSize) {
+    m_w = maze.Width();
+    m_h = maze.Height();
+    m_size = std::max(clusterSize, 2);
+    m_cols = (m_w + m_size - 1) / m_size;
+    m_rows = (m_h + m_size - 1) / m_size;
+    const int clusters = ClusterCount();
+
+    // transitions: tiles per cluster, plus the border steps between them
+    std::vector<std::vector<CellPos>> tiles(static_cast<size_t>(clusters));
+    std::vector<std::pair<CellPos, CellPos>> crossings;
+    auto entrance = [&](CellPos a, CellPos b) {
+        tiles[static_cast<size_t>(ClusterOf(a))].push_back(a);
+        tiles[static_cast<size_t>(ClusterOf(b))].push_back(b);
+        crossings.push_back({a, b});
+    };
+    // walks one border segment: (a + i*along, a + i*along + across) pairs
+    auto scanBorder = [&](CellPos a, DirDelta along, DirDelta across, int length) {
+        int runStart = -1;
+        for (int i = 0; i <= length; ++i) {
+            const CellPos p{a.x + along.dx * i, a.y + along.dy * i};
+            const CellPos q{p.x + across.dx, p.y + across.dy};
+            const bool open = i < length && maze.IsFree(p) && maze.IsFree(q);
+            if (open && runStart < 0) runStart = i;
+            if (open || runStart < 0) continue;
+            const int last = i - 1;
+            auto at = [&](int k) { return CellPos{a.x + along.dx * k, a.y + along.dy * k}; };
+            auto cross = [&](CellPos t) { return CellPos{t.x + across.dx, t.y + across.dy}; };
+            if (last - runStart + 1 < kSplitRun) {
+                const CellPos t = at((runStart + last) / 2);
+                entrance(t, cross(t));
+            } else {
+                entrance(at(runStart), cross(at(runStart)));
+                entrance(at(last), cross(at(last)));
+            }
+            runStart = -1;
+        }
+    };
+    for (int cy = 0; cy < m_rows; ++cy) {
+        for (int cx = 0; cx < m_cols; ++cx) {
+            const Rect r = ClusterRect(cy * m_cols + cx);
+            if (r.x1 < m_w) scanBorder({r.x1 - 1, r.y0}, {0, 1}, {1, 0}, r.Height());
+            if (r.y1 < m_h) scanBorder({r.x0, r.y1 - 1}, {1, 0}, {0, 1}, r.Width());
+        }
+    }
+
+    // node ids grouped by cluster, one node per transition tile
+    m_clusterStart.assign(static_cast<size_t>(clusters) + 1, 0);
+    m_nodePos.clear();
+    for (int c = 0; c < clusters; ++c) {
+        std::vector<CellPos>& t = tiles[static_cast<size_t>(c)];
+        std::sort(t.begin(), t.end(), RowOrder);
+        t.erase(std::unique(t.begin(), t.end()), t.end());
+        m_clusterStart[static_cast<size_t>(c)] = NodeCount();
+        m_nodePos.insert(m_nodePos.end(), t.begin(), t.end());
+    }
+    m_clusterStart[static_cast<size_t>(clusters)] = NodeCount();
+    auto nodeAt = [&](CellPos p) {
+        const int c = ClusterOf(p);
+        const auto first = m_nodePos.begin() + ClusterNodesBegin(c);
+        const auto last = m_nodePos.begin() + ClusterNodesEnd(c);
+        return static_cast<int>(std::lower_bound(first, last, p, RowOrder) - m_nodePos.begin());
+    };
+
+    // edges per node: border steps, then distances inside the cluster
+    std::vector<std::vector<Edge>> out(m_nodePos.size());
+    for (const auto& [a, b] : crossings) {
+        const int na = nodeAt(a);
+        const int nb = nodeAt(b);
+        out[static_cast<size_t>(na)].push_back({nb, 1});
+        out[static_cast<size_t>(nb)].push_back({na, 1});
+    }
+    ThreadPool& pool = ThreadPool::Shared();
+    std::vector<std::vector<int>> dist(static_cast<size_t>(pool.Size()));
+    std::vector<std::vector<int>> queue(static_cast<size_t>(pool.Size()));
+    pool.ParallelFor(clusters, [&](int c, int slot) {
+        const Rect r = ClusterRect(c);
+        std::vector<int>& d = dist[static_cast<size_t>(slot)];
+        for (int n = ClusterNodesBegin(c); n < ClusterNodesEnd(c); ++n) {
+            ClusterBfs(maze, NodePos(n), d, queue[static_cast<size_t>(slot)]);
+            for (int m = ClusterNodesBegin(c); m < ClusterNodesEnd(c); ++m) {
+                const int steps = LocalDist(r, d, NodePos(m));
+                if (m != n && steps != kUnreached) out[static_cast<size_t>(n)].push_back({m, steps});
+            }
+        }
+    });
+
+    m_edgeStart.assign(1, 0);
+    m_edges.clear();
+    for (const std::vector<Edge>& e : out) {
+        m_edges.insert(m_edges.end(), e.begin(), e.end());
+        m_edgeStart.push_back(EdgeCount());
+    }
+}
+
+template void ClusterGraph::Build(const Maze&, int);
+template void ClusterGraph::Build(const MazeView&, int);
+template void ClusterGraph::RectBfs(const Maze&, const Rect&, CellPos, std::vector<int>&, std::vector<int>&);
+template void ClusterGraph::RectBfs(const MazeView&, const Rect&, CellPos, std::vector<int>&, std::vector<int>&);
+
+} // namespace ml
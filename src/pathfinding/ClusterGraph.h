@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "core/Maze.h"
+
+namespace ml {
+
+// HPA* abstraction: the maze cut into square clusters. Where two neighbouring
+// clusters share a run of free tile pairs across their border (an entrance),
+// one transition is placed in the middle of the run, or one at each end for
+// runs of kSplitRun or more. Each transition tile is a node. Nodes are joined
+// by inter-cluster edges (the step across the border, cost 1) and by
+// intra-cluster edges weighted by the shortest distance that stays inside
+// the cluster. Every free path crossing a border can be rerouted through
+// a transition of the same entrance, so the abstract graph keeps connectivity.
+// Node ids are grouped by cluster: ClusterNodesBegin(c)..End(c).
+class ClusterGraph {
+public:
+    static constexpr int kSplitRun = 6;
+    static constexpr int kUnreached = -1;
+
+    struct Edge {
+        int to;   // node id
+        int cost; // steps
+    };
+
+    struct Rect {
+        int x0, y0, x1, y1; // tiles [x0, x1) x [y0, y1)
+        int Width() const noexcept { return x1 - x0; }
+        int Height() const noexcept { return y1 - y0; }
+        bool Contains(CellPos p) const noexcept { return p.x >= x0 && p.y >= y0 && p.x < x1 && p.y < y1; }
+    };
+
+    // Cluster distances are found with one BFS per node, clusters in parallel
+    // on the shared ThreadPool. Grid is Maze or MazeView.
+    template <MazeGrid Grid> void Build(const Grid& maze, int clusterSize);
+
+    int ClusterSize() const noexcept { return m_size; }
+    int ClusterCount() const noexcept { return m_cols * m_rows; }
+    int ClusterOf(CellPos p) const noexcept { return (p.y / m_size) * m_cols + p.x / m_size; }
+    Rect ClusterRect(int cluster) const noexcept;
+    // Smallest rectangle covering both clusters.
+    Rect SpanRect(int a, int b) const noexcept;
+    bool Neighbours(int a, int b) const noexcept {
+        return std::abs(a % m_cols - b % m_cols) <= 1 && std::abs(a / m_cols - b / m_cols) <= 1;
+    }
+
+    int NodeCount() const noexcept { return static_cast<int>(m_nodePos.size()); }
+    int EdgeCount() const noexcept { return static_cast<int>(m_edges.size()); }
+    CellPos NodePos(int node) const noexcept { return m_nodePos[static_cast<size_t>(node)]; }
+    int ClusterNodesBegin(int cluster) const noexcept { return m_clusterStart[static_cast<size_t>(cluster)]; }
+    int ClusterNodesEnd(int cluster) const noexcept { return m_clusterStart[static_cast<size_t>(cluster) + 1]; }
+
+    const Edge* EdgesBegin(int node) const noexcept { return m_edges.data() + m_edgeStart[static_cast<size_t>(node)]; }
+    const Edge* EdgesEnd(int node) const noexcept { return m_edges.data() + m_edgeStart[static_cast<size_t>(node) + 1]; }
+
+    // BFS from `from` that never leaves r. dist covers r row by row
+    // (kUnreached where not reached); queue is scratch.
+    template <MazeGrid Grid>
+    static void RectBfs(const Grid& maze, const Rect& r, CellPos from, std::vector<int>& dist, std::vector<int>& queue);
+    template <MazeGrid Grid>
+    void ClusterBfs(const Grid& maze, CellPos from, std::vector<int>& dist, std::vector<int>& queue) const {
+        RectBfs(maze, ClusterRect(ClusterOf(from)), from, dist, queue);
+    }
+    // Distance from a RectBfs result, kUnreached outside r.
+    static int LocalDist(const Rect& r, const std::vector<int>& dist, CellPos p) noexcept {
+        return r.Contains(p) ? dist[static_cast<size_t>((p.y - r.y0) * r.Width() + (p.x - r.x0))] : kUnreached;
+    }
+
+private:
+    int m_w{0};
+    int m_h{0};
+    int m_size{1};
+    int m_cols{0};
+    int m_rows{0};
+    std::vector<int> m_clusterStart; // ClusterCount() + 1 offsets into node ids
+    std::vector<CellPos> m_nodePos;  // by node id, row order inside a cluster
+    std::vector<int> m_edgeStart;    // NodeCount() + 1 offsets into m_edges
+    std::vector<Edge> m_edges;
+};
+
+} // namespace ml
@@ -0,0 +1,43 @@
+#include "pathfinding/CorridorGraph.h"
+#include "core/MazeFile.h"
+
+namespace ml {
+
+template <MazeGrid Grid>
+void CorridorGraph::Build(const Grid& maze) {
+    m_layout = maze.Layout();
+    m_nodeOf.assign(static_cast<size_t>(m_layout.Count()), -1);
+    m_nodeCell.clear();
+    m_edgeStart.clear();
+    m_edges.clear();
+    if (!maze.Indexed()) return;
+
+    // nodes in row order, from the bit-packed rows
+    for (int y = 0; y < maze.Height(); ++y) {
+        for (int k = 0; k < maze.WordsPerRow(); ++k) {
+            for (uint64_t bits = maze.RowWord(y, k); bits; bits &= bits - 1u) {
+                const int idx = m_layout.Index({k * 64 + std::countr_zero(bits), y});
+                if (!IsNodeDegree(maze.OpenDirsAt(idx))) continue;
+                m_nodeOf[static_cast<size_t>(idx)] = NodeCount();
+                m_nodeCell.push_back(idx);
+            }
+        }
+    }
+
+    // one edge per open direction of each node (every corridor is walked from both ends)
+    m_edgeStart.reserve(m_nodeCell.size() + 1);
+    for (int idx : m_nodeCell) {
+        m_edgeStart.push_back(EdgeCount());
+        for (uint8_t dirs = maze.OpenDirsAt(idx); dirs; dirs &= dirs - 1) {
+            const Dir d = FirstDir(dirs);
+            const WalkEnd end = Walk(maze, idx, d, -1, nullptr);
+            m_edges.push_back({NodeAt(end.idx), end.length, d});
+        }
+    }
+    m_edgeStart.push_back(EdgeCount());
+}
+
+template void CorridorGraph::Build(const Maze&);
+template void CorridorGraph::Build(const MazeView&);
+
+} // namespace ml
@@ -0,0 +1,71 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include "core/Maze.h"
+
+namespace ml {
+
+// The maze collapsed to its decision points: every free tile whose degree is not
+// 2 (junctions, dead ends) is a node, every run of degree-2 tiles between two
+// nodes is an edge weighted by its length. Corridor tiles are not stored; a
+// path is expanded back by walking the corridor from the node (Walk).
+// Tiles on a corridor loop with no junction belong to no edge.
+class CorridorGraph {
+public:
+    struct Edge {
+        int to;     // node id
+        int length; // steps from the source node to `to`
+        Dir dir;    // first step out of the source node
+    };
+
+    struct WalkEnd {
+        int idx;     // layout index where the walk stopped
+        int length;  // steps taken
+        Dir lastDir; // direction of the final step
+    };
+
+    template <MazeGrid Grid> void Build(const Grid& maze); // Maze or MazeView
+
+    const CellLayout& Layout() const noexcept { return m_layout; }
+    int NodeCount() const noexcept { return static_cast<int>(m_nodeCell.size()); }
+    int EdgeCount() const noexcept { return static_cast<int>(m_edges.size()); }
+
+    int NodeAt(int idx) const noexcept { return m_nodeOf[static_cast<size_t>(idx)]; } // -1 = not a node
+    int NodeCell(int node) const noexcept { return m_nodeCell[static_cast<size_t>(node)]; }
+
+    const Edge* EdgesBegin(int node) const noexcept { return m_edges.data() + m_edgeStart[static_cast<size_t>(node)]; }
+    const Edge* EdgesEnd(int node) const noexcept { return m_edges.data() + m_edgeStart[static_cast<size_t>(node) + 1]; }
+
+    // Junctions and dead ends (any degree but 2) are nodes.
+    static bool IsNodeDegree(uint8_t dirs) noexcept { return std::popcount(static_cast<unsigned>(dirs)) != 2; }
+
+    // Leaves `from` in direction d and follows degree-2 tiles until reaching a
+    // node, `stopAt`, or `from` again. Visited tiles are appended to `tiles`.
+    template <MazeGrid Grid>
+    static WalkEnd Walk(const Grid& maze, int from, Dir d, int stopAt, std::vector<int>* tiles) {
+        const CellLayout& layout = maze.Layout();
+        int cur = layout.Step(from, d);
+        int length = 1;
+        while (true) {
+            if (tiles) tiles->push_back(cur);
+            if (cur == stopAt || cur == from) break;
+            uint8_t dirs = maze.OpenDirsAt(cur);
+            if (IsNodeDegree(dirs)) break;
+            dirs &= static_cast<uint8_t>(~DirBit(TurnBack(d)));
+            d = FirstDir(dirs);
+            cur = layout.Step(cur, d);
+            length++;
+        }
+        return {cur, length, d};
+    }
+
+private:
+    CellLayout m_layout;
+    std::vector<int> m_nodeOf;    // by layout index
+    std::vector<int> m_nodeCell;  // by node id
+    std::vector<int> m_edgeStart; // NodeCount() + 1 offsets into m_edges
+    std::vector<Edge> m_edges;
+};
+
+} // namespace ml
@@ -0,0 +1,175 @@
+#include "pathfinding/CorridorPathfinder.h"
+#include "core/MazeFile.h"
+#include <algorithm>
+#include <limits>
+
+namespace ml {
+
+namespace {
+
+// Where a query endpoint joins the graph.
+struct Attach {
+    int node;
+    int dist;
+    Dir dir; // leaving the endpoint (start side) or leaving the node (goal side)
+};
+
+} // namespace
+
+template <MazeGrid Grid>
+void CorridorPathfinder::PrepareGrid(const Grid& maze) {
+    if (m_prepared.Update(maze)) m_graph.Build(maze);
+}
+
+template <MazeGrid Grid>
+PathResult CorridorPathfinder::Search(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    PathResult res;
+
+    if (!SearchableEnds(maze, start, goal)) {
+        res.found = false;
+        return res;
+    }
+
+    PrepareGrid(maze);
+
+    const CellLayout& layout = maze.Layout();
+    const int si = layout.Index(start);
+    const int gi = layout.Index(goal);
+    if (si == gi) {
+        res.found = true;
+        res.path.push_back(start);
+        return res;
+    }
+
+    const int INF = std::numeric_limits<int>::max() / 4;
+    int best = INF;
+    int bestNode = -1;  // -1: direct corridor walk from start
+    Dir directDir = Dir::N;
+
+    // start side: itself if it is a node, else the two ends of its corridor
+    std::vector<Attach> fromStart;
+    if (m_graph.NodeAt(si) >= 0) {
+        fromStart.push_back({m_graph.NodeAt(si), 0, Dir::N});
+    } else {
+        for (uint8_t dirs = maze.OpenDirsAt(si); dirs; dirs &= dirs - 1) {
+            const Dir d = FirstDir(dirs);
+            const CorridorGraph::WalkEnd end = CorridorGraph::Walk(maze, si, d, gi, nullptr);
+            if (end.idx == gi) {
+                if (end.length < best) { best = end.length; directDir = d; }
+            } else if (end.idx != si) {
+                fromStart.push_back({m_graph.NodeAt(end.idx), end.length, d});
+            }
+        }
+    }
+
+    // goal side, stored as node -> remaining distance
+    std::vector<Attach> toGoal;
+    if (m_graph.NodeAt(gi) >= 0) {
+        toGoal.push_back({m_graph.NodeAt(gi), 0, Dir::N});
+    } else {
+        // a corridor start was already tried for the direct walk; a node start is a normal graph node
+        const int stopAt = m_graph.NodeAt(si) >= 0 ? -1 : si;
+        for (uint8_t dirs = maze.OpenDirsAt(gi); dirs; dirs &= dirs - 1) {
+            const CorridorGraph::WalkEnd end = CorridorGraph::Walk(maze, gi, FirstDir(dirs), stopAt, nullptr);
+            if (end.idx == stopAt || end.idx == gi) continue;
+            toGoal.push_back({m_graph.NodeAt(end.idx), end.length, TurnBack(end.lastDir)});
+        }
+    }
+
+    // per graph node: g, and the node it was reached from (-2 - k for fromStart[k]);
+    // an edge is at least as long as the Manhattan distance it spans, so
+    // f = g + h is a non-negative integer that never drops along a search
+    const int nodes = m_graph.NodeCount();
+    ws.Begin(nodes);
+    BucketQueue<int>& open = ws.Buckets();
+    open.Reset(static_cast<size_t>(nodes));
+
+    auto nodePos = [&](int n) { return layout.Pos(m_graph.NodeCell(n)); };
+
+    for (size_t k = 0; k < fromStart.size(); ++k) {
+        const Attach& a = fromStart[k];
+        if (a.dist >= ws.G(a.node)) continue;
+        ws.Reach(a.node, -2 - static_cast<int>(k), a.dist);
+        open.Push(a.node, a.dist + Manhattan(nodePos(a.node), goal));
+    }
+
+    while (!open.Empty() && open.TopPriority() < best) {
+        const int node = open.Pop();
+        const int g = ws.G(node);
+        ws.Close(node);
+        res.expandedNodes++;
+
+        for (const Attach& t : toGoal) {
+            if (t.node == node && g + t.dist < best) {
+                best = g + t.dist;
+                bestNode = node;
+            }
+        }
+
+        for (const CorridorGraph::Edge* e = m_graph.EdgesBegin(node); e != m_graph.EdgesEnd(node); ++e) {
+            if (ws.Closed(e->to)) continue;
+            const int tentativeG = g + e->length;
+            if (tentativeG < ws.G(e->to)) {
+                ws.Reach(e->to, node, tentativeG);
+                open.Push(e->to, tentativeG + Manhattan(nodePos(e->to), goal));
+            }
+        }
+    }
+
+    if (best == INF) {
+        res.found = false;
+        return res;
+    }
+
+    // expand back to tiles
+    std::vector<int> tiles;
+    tiles.reserve(static_cast<size_t>(best) + 1);
+    tiles.push_back(si);
+    if (bestNode < 0) {
+        CorridorGraph::Walk(maze, si, directDir, gi, &tiles);
+    } else {
+        const CorridorGraph::Edge* e0 = m_graph.EdgesBegin(0);
+        std::vector<int> chain; // edge indices from the start side, reversed
+        int n = bestNode;
+        int attach = -1;
+        while (true) {
+            const int prev = ws.Prev(n);
+            if (prev <= -2) { attach = -2 - prev; break; }
+            // the edge out of prev whose length accounts for n's g
+            const CorridorGraph::Edge* e = m_graph.EdgesBegin(prev);
+            while (e->to != n || ws.G(prev) + e->length != ws.G(n)) ++e;
+            chain.push_back(static_cast<int>(e - e0));
+            n = prev;
+        }
+        if (fromStart[static_cast<size_t>(attach)].dist > 0) {
+            CorridorGraph::Walk(maze, si, fromStart[static_cast<size_t>(attach)].dir, -1, &tiles);
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            CorridorGraph::Walk(maze, tiles.back(), e0[*it].dir, -1, &tiles);
+        }
+        for (const Attach& t : toGoal) {
+            if (t.node == bestNode && best == ws.G(bestNode) + t.dist) {
+                if (t.dist > 0) CorridorGraph::Walk(maze, tiles.back(), t.dir, gi, &tiles);
+                break;
+            }
+        }
+    }
+
+    res.found = true;
+    res.path.reserve(tiles.size());
+    for (int idx : tiles) res.path.push_back(layout.Pos(idx));
+    return res;
+}
+
+void CorridorPathfinder::Prepare(const Maze& maze) { PrepareGrid(maze); }
+void CorridorPathfinder::Prepare(const MazeView& view) { PrepareGrid(view); }
+
+PathResult CorridorPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return Search(maze, start, goal, ws);
+}
+
+PathResult CorridorPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return Search(view, start, goal, ws);
+}
+
+} // namespace ml
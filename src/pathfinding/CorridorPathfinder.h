@@ -0,0 +1,34 @@
+#pragma once
+#include "pathfinding/IPathfinder.h"
+#include "pathfinding/CorridorGraph.h"
+
+namespace ml {
+
+// A* over the CorridorGraph instead of the tile grid. Start and goal attach to
+// the graph by walking their own corridors; the result is expanded back to a
+// tile path. expandedNodes counts graph nodes, so on perfect (DFS/Prim) mazes
+// it is a small fraction of what the tile searches report.
+// The graph is rebuilt only when the maze fingerprint changes.
+class CorridorPathfinder final : public IPathfinder {
+public:
+    std::string Name() const override { return "Corridor A*"; }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override {
+        return FindPath(maze, start, goal, m_workspace);
+    }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    void Prepare(const Maze& maze) override;
+    PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    void Prepare(const MazeView& view) override;
+
+    const CorridorGraph& Graph() const noexcept { return m_graph; }
+
+private:
+    template <MazeGrid Grid> PathResult Search(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws);
+    template <MazeGrid Grid> void PrepareGrid(const Grid& maze);
+
+    CorridorGraph m_graph;
+    SearchWorkspace m_workspace; // graph node state of the 3-argument FindPath
+    PreparedMaze m_prepared;
+};
+
+} // namespace ml
@@ -0,0 +1,66 @@
+#include "pathfinding/DeadEndFilling.h"
+#include "pathfinding/PathTypes.h"
+#include <bit>
+
+namespace ml {
+
+static int Degree(uint8_t dirs) { return std::popcount(static_cast<unsigned>(dirs)); }
+
+Maze FillDeadEnds(const Maze& maze, CellPos start, CellPos goal) {
+    Maze out(maze);
+    if (!out.Indexed()) return out;
+    const CellLayout& layout = out.Layout();
+    const int si = maze.InBounds(start) ? layout.Index(start) : -1;
+    const int gi = maze.InBounds(goal) ? layout.Index(goal) : -1;
+
+    std::vector<int> stack;
+    for (int y = 0; y < out.Height(); ++y) {
+        for (int k = 0; k < out.WordsPerRow(); ++k) {
+            for (uint64_t bits = out.RowWord(y, k); bits; bits &= bits - 1u) {
+                const int idx = layout.Index({k * 64 + std::countr_zero(bits), y});
+                if (idx != si && idx != gi && Degree(out.OpenDirsAt(idx)) <= 1) stack.push_back(idx);
+            }
+        }
+    }
+
+    // degrees only go down, so a queued tile is still a dead end when popped
+    while (!stack.empty()) {
+        const int ci = stack.back();
+        stack.pop_back();
+        const uint8_t open = out.OpenDirsAt(ci);
+        out.SetFree(layout.Pos(ci), false);
+
+        for (uint8_t dirs = open; dirs; dirs &= dirs - 1) {
+            const int ni = layout.Step(ci, FirstDir(dirs));
+            if (ni == si || ni == gi) continue;
+            if (Degree(out.OpenDirsAt(ni)) == 1) stack.push_back(ni);
+        }
+    }
+    return out;
+}
+
+bool TraceSinglePath(const Maze& maze, CellPos start, CellPos goal, std::vector<CellPos>& path) {
+    path.clear();
+    if (!SearchableEnds(maze, start, goal)) return false;
+
+    const CellLayout& layout = maze.Layout();
+    const int gi = layout.Index(goal);
+    int ci = layout.Index(start);
+    path.push_back(start);
+    if (ci == gi) return Degree(maze.OpenDirsAt(ci)) == 0;
+
+    uint8_t dirs = maze.OpenDirsAt(ci);
+    if (Degree(dirs) != 1) return false;
+    Dir d = FirstDir(dirs);
+    while (true) {
+        ci = layout.Step(ci, d);
+        path.push_back(layout.Pos(ci));
+        dirs = maze.OpenDirsAt(ci);
+        if (ci == gi) return Degree(dirs) == 1;
+        dirs &= static_cast<uint8_t>(~DirBit(TurnBack(d)));
+        if (Degree(dirs) != 1) return false;
+        d = FirstDir(dirs);
+    }
+}
+
+} // namespace ml
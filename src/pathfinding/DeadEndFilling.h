@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+#include "core/Maze.h"
+
+namespace ml {
+
+// Dead-end filling: walls up every free tile with at most one free neighbour
+// (start and goal excepted) until none is left. Linear in the number of tiles:
+// each tile is filled once and only its neighbours are re-checked.
+// Every simple start->goal path survives, so shortest paths on the result are
+// shortest paths of the input. On a perfect (DFS/Prim) maze only the solution
+// path remains; loops and their connecting corridors stay in general.
+Maze FillDeadEnds(const Maze& maze, CellPos start, CellPos goal);
+
+// Follows the free tiles from start to goal when every step has exactly one
+// way on (the shape FillDeadEnds leaves on a perfect maze). False, with path
+// left unspecified, as soon as a branch, a loop or a dead end shows up.
+bool TraceSinglePath(const Maze& maze, CellPos start, CellPos goal, std::vector<CellPos>& path);
+
+} // namespace ml
@@ -0,0 +1,146 @@
+#include "pathfinding/DistanceField.h"
+#include <algorithm>
+#include <bit>
+
+namespace ml {
+
+void DistanceField::Build(const Maze& maze, CellPos source, int maxDist, bool dense) {
+    Build(maze, std::vector<CellPos>{source}, maxDist, dense);
+}
+
+void DistanceField::Build(const Maze& maze, const std::vector<CellPos>& sources, int maxDist, bool dense) {
+    m_layout = maze.Layout();
+    m_w = maze.Width();
+    m_h = maze.Height();
+    m_words = maze.WordsPerRow();
+    m_stride = static_cast<size_t>(m_words) + 2;
+    const size_t cells = m_stride * static_cast<size_t>(m_h + 2);
+
+    m_free.assign(cells, 0u);
+    m_next.assign(cells, 0u);
+    for (int y = 0; y < m_h; ++y) {
+        uint64_t* row = m_free.data() + static_cast<size_t>(y + 1) * m_stride + 1;
+        for (int k = 0; k < m_words; ++k) row[k] = maze.RowWord(y, k);
+    }
+    m_open = m_free;
+    m_head.assign(cells, kNoFront);
+    m_touched.clear();
+    m_layers.clear();
+    m_waveStart.assign(1, 0u);
+    m_dist.clear();
+    m_waves = 0;
+    m_reached = 0;
+
+    for (const CellPos& s : sources) {
+        if (!maze.Indexed() || !maze.InBounds(s) || maze.IsWall(s)) continue;
+        const uint32_t word = WordAt(s);
+        const uint64_t bit = (uint64_t{1} << (s.x & 63)) & m_open[word];
+        if (!bit) continue;
+        m_open[word] &= ~bit;
+        Land(word, bit);
+    }
+    m_waveStart.push_back(static_cast<uint32_t>(m_layers.size()));
+
+    for (int dist = 1; dist <= maxDist && m_waveStart[dist] > m_waveStart[dist - 1]; ++dist) {
+        for (uint32_t i = m_waveStart[dist - 1]; i < m_waveStart[dist]; ++i) Scatter(m_layers[i].word, m_layers[i].bits);
+        if (m_touched.empty()) break;
+
+        for (uint32_t word : m_touched) {
+            const uint64_t bits = m_next[word];
+            m_next[word] = 0u;
+            m_open[word] &= ~bits;
+            Land(word, bits);
+        }
+        m_touched.clear();
+        m_waveStart.push_back(static_cast<uint32_t>(m_layers.size()));
+        m_waves = dist;
+    }
+
+    if (dense) {
+        m_dist.assign(static_cast<size_t>(m_layout.Count()), kUnreached);
+        for (int d = 0; d + 1 < static_cast<int>(m_waveStart.size()); ++d) {
+            for (uint32_t i = m_waveStart[d]; i < m_waveStart[d + 1]; ++i) {
+                const Front& f = m_layers[i];
+                const int y = static_cast<int>(f.word / m_stride) - 1;
+                const int x0 = (static_cast<int>(f.word % m_stride) - 1) * 64;
+                for (uint64_t bits = f.bits; bits; bits &= bits - 1u) {
+                    m_dist[static_cast<size_t>(m_layout.Index({x0 + std::countr_zero(bits), y}))] = d;
+                }
+            }
+        }
+    }
+}
+
+void DistanceField::Scatter(uint32_t word, uint64_t bits) {
+    auto add = [&](size_t at, uint64_t b) {
+        b &= m_open[at];
+        if (!b) return;
+        if (!m_next[at]) m_touched.push_back(static_cast<uint32_t>(at));
+        m_next[at] |= b;
+    };
+    const size_t w = word;
+    add(w, (bits << 1) | (bits >> 1));
+    add(w - 1, bits << 63);
+    add(w + 1, bits >> 63);
+    add(w - m_stride, bits);
+    add(w + m_stride, bits);
+}
+
+void DistanceField::Land(uint32_t word, uint64_t bits) {
+    m_layers.push_back({word, m_head[word], bits});
+    m_head[word] = static_cast<uint32_t>(m_layers.size() - 1);
+    m_reached += static_cast<size_t>(std::popcount(bits));
+}
+
+int DistanceField::Distance(CellPos p) const noexcept {
+    if (!m_layout.InBounds(p)) return kUnreached;
+    if (!m_dist.empty()) return m_dist[static_cast<size_t>(m_layout.Index(p))];
+    // each front on a word adds at least one of its bits, so the chain is short
+    const uint64_t bit = uint64_t{1} << (p.x & 63);
+    for (uint32_t i = m_head[WordAt(p)]; i != kNoFront; i = m_layers[i].next) {
+        if (m_layers[i].bits & bit) {
+            return static_cast<int>(std::upper_bound(m_waveStart.begin(), m_waveStart.end(), i) - m_waveStart.begin()) - 1;
+        }
+    }
+    return kUnreached;
+}
+
+bool DistanceField::InWave(CellPos p, int wave) const noexcept {
+    const uint64_t bit = uint64_t{1} << (p.x & 63);
+    const uint32_t begin = m_waveStart[static_cast<size_t>(wave)];
+    const uint32_t end = m_waveStart[static_cast<size_t>(wave) + 1];
+    // newest first: stop once the chain drops below the wave
+    for (uint32_t i = m_head[WordAt(p)]; i != kNoFront && i >= begin; i = m_layers[i].next) {
+        if (i < end && (m_layers[i].bits & bit)) return true;
+    }
+    return false;
+}
+
+uint64_t DistanceField::ReachedWord(int y, int k) const noexcept {
+    if (y < 0 || y >= m_h || k < 0 || k >= m_words) return 0u;
+    const size_t at = static_cast<size_t>(y + 1) * m_stride + static_cast<size_t>(k) + 1;
+    return m_free[at] & ~m_open[at];
+}
+
+bool DistanceField::PathToSource(const Maze& maze, CellPos p, std::vector<CellPos>& path) const {
+    path.clear();
+    int d = Distance(p);
+    if (d == kUnreached) return false;
+    const CellLayout& layout = maze.Layout();
+    path.push_back(p);
+    for (; d > 0; --d) {
+        // some open neighbour is in the wave before
+        for (uint8_t dirs = maze.OpenDirsAt(layout.Index(p)); dirs; dirs &= dirs - 1) {
+            const DirDelta step = Delta(FirstDir(dirs));
+            const CellPos n{p.x + step.dx, p.y + step.dy};
+            if (InWave(n, d - 1)) {
+                p = n;
+                break;
+            }
+        }
+        path.push_back(p);
+    }
+    return true;
+}
+
+} // namespace ml
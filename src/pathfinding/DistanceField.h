@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "core/Maze.h"
+
+namespace ml {
+
+// Breadth-first distances from one or more source tiles, advanced a whole
+// wave at a time on bit-packed rows: the frontier words are shifted left,
+// right, up and down and ANDed with the free tiles not reached yet; the
+// surviving bits become the next wave. Only the words next to the frontier
+// are touched, so a wave costs its width in 64-tile words, not in tiles.
+// Each wave is kept as its list of words, chained per word, and distances are
+// read back from those layers; one int per tile is only written on request.
+class DistanceField {
+public:
+    static constexpr int kUnreached = -1;
+    static constexpr int kNoLimit = std::numeric_limits<int>::max();
+
+    // Floods from the free sources (walls and out-of-bounds ones are ignored,
+    // all of them if the maze is not Indexed()) for at most maxDist waves.
+    // dense also fills Distances() from the layers once the flood is done.
+    void Build(const Maze& maze, CellPos source, int maxDist = kNoLimit, bool dense = false);
+    void Build(const Maze& maze, const std::vector<CellPos>& sources, int maxDist = kNoLimit, bool dense = false);
+
+    // Steps to the nearest source, kUnreached if none within the limit. Without
+    // the dense array this walks the waves that reached p's word (at most 64).
+    int Distance(CellPos p) const noexcept;
+    // By CellLayout index of the maze the field was built on; empty unless
+    // Build was asked for it.
+    const std::vector<int>& Distances() const noexcept { return m_dist; }
+
+    int Waves() const noexcept { return m_waves; }     // largest distance reached
+    size_t Reached() const noexcept { return m_reached; }
+
+    // Tiles reached by Build (those within maxDist steps), laid out like
+    // Maze::RowWord: bit i of word k is tile (k*64 + i, y).
+    uint64_t ReachedWord(int y, int k) const noexcept;
+
+    // Shortest path from p down to the nearest source (p first). False if p
+    // was not reached.
+    bool PathToSource(const Maze& maze, CellPos p, std::vector<CellPos>& path) const;
+
+private:
+    static constexpr uint32_t kNoFront = ~uint32_t{0};
+
+    struct Front {
+        uint32_t word; // offset into the padded grids
+        uint32_t next; // earlier front on the same word, kNoFront if none
+        uint64_t bits;
+    };
+
+    uint32_t WordAt(CellPos p) const noexcept {
+        return static_cast<uint32_t>(static_cast<size_t>(p.y + 1) * m_stride + static_cast<size_t>(p.x >> 6) + 1);
+    }
+    bool InWave(CellPos p, int wave) const noexcept;
+    void Scatter(uint32_t word, uint64_t bits);
+    void Land(uint32_t word, uint64_t bits);
+
+    CellLayout m_layout;
+    int m_w{0};
+    int m_h{0};
+    // m_words words per row plus a wall word on each side, and a wall row above
+    // and below, so the four shifts never need bounds checks.
+    int m_words{0};
+    size_t m_stride{0};
+    std::vector<uint64_t> m_free;
+    std::vector<uint64_t> m_open;     // free and not reached yet
+    std::vector<uint64_t> m_next;     // bits gathered for the next wave
+    std::vector<uint32_t> m_touched;  // words of m_next that are non-zero
+
+    std::vector<Front> m_layers;        // the fronts of every wave, wave after wave
+    std::vector<uint32_t> m_waveStart;  // wave d is m_layers[m_waveStart[d], m_waveStart[d + 1])
+    std::vector<uint32_t> m_head;       // per padded word: its latest front, kNoFront if none
+    std::vector<int> m_dist;
+    int m_waves{0};
+    size_t m_reached{0};
+};
+
+} // namespace ml
@@ -0,0 +1,163 @@
+#include "pathfinding/HPAPathfinder.h"
+#include "core/MazeFile.h"
+#include <algorithm>
+
+namespace ml {
+
+template <MazeGrid Grid>
+void HPAPathfinder::PrepareGrid(const Grid& maze) {
+    if (m_prepared.Update(maze)) m_graph.Build(maze, m_clusterSize);
+}
+
+template <MazeGrid Grid>
+HPARoute HPAPathfinder::FindRoute(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    HPARoute route;
+    if (!maze.InBounds(start) || !maze.InBounds(goal) || maze.IsWall(start) || maze.IsWall(goal)) {
+        return route;
+    }
+    PrepareGrid(maze);
+
+    // start and goal join the graph as two extra nodes
+    const int nodes = m_graph.NodeCount();
+    const int sNode = nodes;
+    const int gNode = nodes + 1;
+    const int sc = m_graph.ClusterOf(start);
+    const int gc = m_graph.ClusterOf(goal);
+    const ClusterGraph::Rect sr = m_graph.ClusterRect(sc);
+    const ClusterGraph::Rect gr = m_graph.ClusterRect(gc);
+    std::vector<int> sDist, gDist, queue;
+    m_graph.ClusterBfs(maze, start, sDist, queue);
+    m_graph.ClusterBfs(maze, goal, gDist, queue);
+    // nearby endpoints also get a direct edge through the clusters spanning
+    // them, so short routes need not detour through a transition
+    int direct = ClusterGraph::LocalDist(sr, sDist, goal);
+    if (sc != gc && m_graph.Neighbours(sc, gc)) {
+        const ClusterGraph::Rect span = m_graph.SpanRect(sc, gc);
+        std::vector<int> spanDist;
+        ClusterGraph::RectBfs(maze, span, start, spanDist, queue);
+        direct = ClusterGraph::LocalDist(span, spanDist, goal);
+    }
+    auto pos = [&](int v) { return v == sNode ? start : v == gNode ? goal : m_graph.NodePos(v); };
+
+    // edge costs are tile distances, never below the Manhattan distance, so
+    // f = g + h is a non-negative integer that never drops along a search
+    ws.Begin(nodes + 2);
+    BucketQueue<int>& open = ws.Buckets();
+    open.Reset(static_cast<size_t>(nodes) + 2);
+    auto relax = [&](int from, int to, int g) {
+        if (ws.Closed(to) || g >= ws.G(to)) return;
+        ws.Reach(to, from, g);
+        open.Push(to, g + Manhattan(pos(to), goal));
+    };
+    ws.Reach(sNode, -1, 0);
+    open.Push(sNode, Manhattan(start, goal));
+
+    while (!open.Empty()) {
+        const int node = open.Pop();
+        const int g = ws.G(node);
+        ws.Close(node);
+        route.expandedNodes++;
+        if (node == gNode) break;
+
+        if (node == sNode) {
+            for (int v = m_graph.ClusterNodesBegin(sc); v < m_graph.ClusterNodesEnd(sc); ++v) {
+                const int d = ClusterGraph::LocalDist(sr, sDist, pos(v));
+                if (d != ClusterGraph::kUnreached) relax(sNode, v, d);
+            }
+            if (direct != ClusterGraph::kUnreached) relax(sNode, gNode, direct);
+            continue;
+        }
+        for (const ClusterGraph::Edge* e = m_graph.EdgesBegin(node); e != m_graph.EdgesEnd(node); ++e) {
+            relax(node, e->to, g + e->cost);
+        }
+        const int toGoal = ClusterGraph::LocalDist(gr, gDist, pos(node));
+        if (toGoal != ClusterGraph::kUnreached) relax(node, gNode, g + toGoal);
+    }
+
+    if (!ws.Closed(gNode)) return route;
+    route.found = true;
+    route.length = ws.G(gNode);
+    for (int v = gNode; v != -1; v = ws.Prev(v)) {
+        // an endpoint on a transition tile joins it with a zero-length edge
+        if (route.waypoints.empty() || route.waypoints.back() != pos(v)) route.waypoints.push_back(pos(v));
+    }
+    std::reverse(route.waypoints.begin(), route.waypoints.end());
+    return route;
+}
+
+template <MazeGrid Grid>
+bool HPAPathfinder::RefineSegment(const Grid& maze, const HPARoute& route, size_t segment, std::vector<CellPos>& path) const {
+    if (segment >= route.Segments()) return false;
+    const CellPos a = route.waypoints[segment];
+    const CellPos b = route.waypoints[segment + 1];
+    const int ca = m_graph.ClusterOf(a);
+    const int cb = m_graph.ClusterOf(b);
+    if (ca != cb && Manhattan(a, b) == 1) {
+        // a border step
+        path.push_back(b);
+        return true;
+    }
+    if (!m_graph.Neighbours(ca, cb)) return false;
+
+    // walk downhill on the distances to b inside the cluster (or the pair of
+    // clusters of a direct start-goal edge)
+    const ClusterGraph::Rect r = m_graph.SpanRect(ca, cb);
+    std::vector<int> dist, queue;
+    ClusterGraph::RectBfs(maze, r, b, dist, queue);
+    int d = ClusterGraph::LocalDist(r, dist, a);
+    if (d == ClusterGraph::kUnreached) return false;
+    CellPos p = a;
+    while (d > 0) {
+        for (uint8_t dirs = maze.OpenDirs(p); dirs; dirs &= dirs - 1) {
+            const DirDelta dd = Delta(FirstDir(dirs));
+            const CellPos n{p.x + dd.dx, p.y + dd.dy};
+            if (ClusterGraph::LocalDist(r, dist, n) == d - 1) {
+                p = n;
+                break;
+            }
+        }
+        --d;
+        path.push_back(p);
+    }
+    return true;
+}
+
+template <MazeGrid Grid>
+PathResult HPAPathfinder::Search(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    PathResult res;
+    const HPARoute route = FindRoute(maze, start, goal, ws);
+    res.expandedNodes = route.expandedNodes;
+    if (!route.found) {
+        res.found = false;
+        return res;
+    }
+    res.path.reserve(static_cast<size_t>(route.length) + 1);
+    res.path.push_back(start);
+    for (size_t i = 0; i < route.Segments(); ++i) {
+        if (!RefineSegment(maze, route, i, res.path)) {
+            res.found = false;
+            res.path.clear();
+            return res;
+        }
+    }
+    res.found = true;
+    return res;
+}
+
+void HPAPathfinder::Prepare(const Maze& maze) { PrepareGrid(maze); }
+void HPAPathfinder::Prepare(const MazeView& view) { PrepareGrid(view); }
+
+PathResult HPAPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return Search(maze, start, goal, ws);
+}
+
+PathResult HPAPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return Search(view, start, goal, ws);
+}
+
+template HPARoute HPAPathfinder::FindRoute(const Maze&, CellPos, CellPos, SearchWorkspace&);
+template HPARoute HPAPathfinder::FindRoute(const MazeView&, CellPos, CellPos, SearchWorkspace&);
+template bool HPAPathfinder::RefineSegment(const Maze&, const HPARoute&, size_t, std::vector<CellPos>&) const;
+template bool HPAPathfinder::RefineSegment(const MazeView&, const HPARoute&, size_t, std::vector<CellPos>&) const;
+
+} // namespace ml
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "pathfinding/IPathfinder.h"
+#include "pathfinding/ClusterGraph.h"
+
+namespace ml {
+
+// Abstract HPA* route: start, transition tiles, goal. Consecutive waypoints
+// are one step apart across a cluster border or inside one cluster.
+struct HPARoute {
+    bool found{false};
+    std::vector<CellPos> waypoints;
+    int length{0};        // steps of the refined path
+    int expandedNodes{0}; // abstract nodes
+
+    size_t Segments() const noexcept { return waypoints.size() > 1 ? waypoints.size() - 1 : 0; }
+};
+
+// Hierarchical A* over a ClusterGraph. Start and goal join the graph through a
+// BFS inside their own cluster, A* runs on the abstract nodes, and a segment
+// is turned back into tiles only when asked for (RefineSegment); FindPath
+// refines all of them. Endpoints in neighbouring clusters also get a direct
+// edge through the two clusters. Routes go through transitions and stay
+// inside clusters between them, so they can be longer than the shortest
+// path. Measured against BFS with 32-tile clusters: exact on perfect mazes
+// (the path is unique), on caves +0.3% on average for long queries (worst
+// +3.6%) and +1.8% for short ones (worst 1.4x, on paths of a few steps).
+// expandedNodes counts abstract nodes. The cluster graph is rebuilt when the
+// maze fingerprint changes.
+class HPAPathfinder final : public IPathfinder {
+public:
+    static constexpr int kDefaultClusterSize = 32;
+
+    explicit HPAPathfinder(int clusterSize = kDefaultClusterSize) : m_clusterSize(clusterSize) {}
+
+    std::string Name() const override { return "HPA*"; }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override {
+        return FindPath(maze, start, goal, m_workspace);
+    }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    void Prepare(const Maze& maze) override;
+    PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    void Prepare(const MazeView& view) override;
+
+    // Abstract search only (ws holds abstract node state). Grid is Maze or MazeView.
+    template <MazeGrid Grid>
+    HPARoute FindRoute(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws);
+    // Appends the tiles of segment i, waypoints[i] excluded and waypoints[i+1]
+    // included, to path. Needs the maze the route was found on.
+    template <MazeGrid Grid>
+    bool RefineSegment(const Grid& maze, const HPARoute& route, size_t segment, std::vector<CellPos>& path) const;
+
+    const ClusterGraph& Graph() const noexcept { return m_graph; }
+
+private:
+    template <MazeGrid Grid> PathResult Search(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws);
+    template <MazeGrid Grid> void PrepareGrid(const Grid& maze);
+
+    int m_clusterSize;
+    ClusterGraph m_graph;
+    SearchWorkspace m_workspace;
+    PreparedMaze m_prepared;
+};
+
+} // namespace ml
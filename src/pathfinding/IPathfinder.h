@@ -1,15 +1,53 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include "core/Maze.h"
 #include "pathfinding/PathTypes.h"
+#include "pathfinding/SearchWorkspace.h"
 
 namespace ml {
 
+class MazeView;
+
 class IPathfinder {
 public:
     virtual ~IPathfinder() = default;
     virtual std::string Name() const = 0;
     virtual PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) = 0;
+    // Same query on caller-owned scratch, e.g. one workspace per thread over a
+    // shared pathfinder. Pathfinders without per-tile state ignore it.
+    virtual PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+        (void)ws;
+        return FindPath(maze, start, goal);
+    }
+    // Builds the per-maze caches a query would build on first use. Afterwards
+    // the 4-argument FindPath on that maze only reads the pathfinder, so
+    // threads with their own workspaces may share it (see FindPaths).
+    virtual void Prepare(const Maze& maze) { (void)maze; }
+
+    // The same search on a mapped .mlzb file, without copying it into a Maze.
+    // Caches are keyed by the content fingerprint, so a view and a Maze copy
+    // of it share them.
+    virtual PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) = 0;
+    virtual void Prepare(const MazeView& view) { (void)view; }
+};
+
+// The maze a pathfinder's cache was last built for. The fingerprint does not
+// cover the size, so both are compared.
+struct PreparedMaze {
+    uint64_t fingerprint{0};
+    int width{0};
+    int height{0};
+
+    // True when maze is not the one recorded, which it then becomes.
+    template <MazeGrid Grid> bool Update(const Grid& maze) {
+        const uint64_t fp = maze.Fingerprint();
+        if (fp == fingerprint && maze.Width() == width && maze.Height() == height) return false;
+        fingerprint = fp;
+        width = maze.Width();
+        height = maze.Height();
+        return true;
+    }
 };
 
 } // namespace ml
@@ -0,0 +1,226 @@
+#include "pathfinding/JPSPathfinder.h"
+#include "core/MazeFile.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ml {
+
+namespace {
+
+constexpr uint8_t kSides = DirBit(Dir::E) | DirBit(Dir::W);
+constexpr uint8_t kVertical = DirBit(Dir::N) | DirBit(Dir::S);
+constexpr uint32_t kJumpBit = 0x80000000u;
+constexpr uint32_t kStepsMask = kJumpBit - 1u;
+
+bool IsHorizontal(Dir d) { return d == Dir::E || d == Dir::W; }
+
+// Runs read from the jump table, plus the goal (which the table ignores).
+class Jumper {
+public:
+    Jumper(const std::vector<uint32_t>& jumps, const CellLayout& layout, CellPos goal)
+        : m_jumps(jumps), m_layout(layout), m_goal(goal) {}
+
+    // Steps from (idx, at) in direction d to the first jump point, 0 for none.
+    int Jump(int idx, CellPos at, Dir d) const {
+        const uint32_t e = Entry(idx, d);
+        const int run = static_cast<int>(e & kStepsMask);
+        int stop = (e & kJumpBit) ? run : 0;
+        auto consider = [&](int steps) {
+            if (steps > 0 && steps <= run && (stop == 0 || steps < stop)) stop = steps;
+        };
+
+        const DirDelta dd = Delta(d);
+        if (dd.dx != 0) {
+            if (m_goal.y == at.y) {
+                consider((m_goal.x - at.x) * dd.dx);
+            } else {
+                // the cell in the goal's column is a jump point if its vertical
+                // run reaches the goal (a forced cell on the way would already
+                // have made it one in the table)
+                const int steps = (m_goal.x - at.x) * dd.dx;
+                if (steps > 0 && steps <= run) {
+                    const Dir v = m_goal.y < at.y ? Dir::N : Dir::S;
+                    const uint32_t ve = Entry(m_layout.Index({m_goal.x, at.y}), v);
+                    if (std::abs(m_goal.y - at.y) <= static_cast<int>(ve & kStepsMask)) consider(steps);
+                }
+            }
+        } else if (m_goal.x == at.x) {
+            consider((m_goal.y - at.y) * dd.dy);
+        }
+        return stop;
+    }
+
+private:
+    uint32_t Entry(int idx, Dir d) const {
+        return m_jumps[static_cast<size_t>(idx) * 4 + static_cast<size_t>(d)];
+    }
+
+    const std::vector<uint32_t>& m_jumps;
+    const CellLayout& m_layout;
+    CellPos m_goal;
+};
+
+// Directions worth jumping in from a jump point reached by `arrival`.
+template <MazeGrid Grid>
+uint8_t Successors(const Grid& maze, int idx, Dir arrival, bool start) {
+    const uint8_t open = maze.OpenDirsAt(idx);
+    if (start) return open;
+    if (IsHorizontal(arrival)) return open & (DirBit(arrival) | kVertical);
+    const uint8_t behind = maze.OpenDirsAt(maze.Layout().Step(idx, TurnBack(arrival)));
+    return open & (DirBit(arrival) | (kSides & ~behind));
+}
+
+} // namespace
+
+template <MazeGrid Grid>
+void JPSPathfinder::BuildJumps(const Grid& maze) {
+    const CellLayout& layout = maze.Layout();
+    const int w = maze.Width();
+    const int h = maze.Height();
+    m_jumps.assign(static_cast<size_t>(layout.Count()) * 4, 0u);
+    if (!maze.Indexed()) return;
+    auto at = [&](int idx, Dir d) -> uint32_t& {
+        return m_jumps[static_cast<size_t>(idx) * 4 + static_cast<size_t>(d)];
+    };
+    // one step further than the neighbour's entry, or a jump point right there
+    auto extend = [&](int idx, Dir d, bool stopAtNext) {
+        const int next = layout.Step(idx, d);
+        at(idx, d) = stopAtNext ? (kJumpBit | 1u) : at(next, d) + 1u;
+    };
+
+    // vertical runs stop where a side opening appears
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const int idx = layout.Index({x, y});
+            const uint8_t open = maze.OpenDirsAt(idx);
+            if (open & DirBit(Dir::N)) {
+                const int next = layout.Step(idx, Dir::N);
+                extend(idx, Dir::N, (maze.OpenDirsAt(next) & kSides & ~open) != 0);
+            }
+        }
+    }
+    for (int y = h - 1; y >= 0; --y) {
+        for (int x = 0; x < w; ++x) {
+            const int idx = layout.Index({x, y});
+            const uint8_t open = maze.OpenDirsAt(idx);
+            if (open & DirBit(Dir::S)) {
+                const int next = layout.Step(idx, Dir::S);
+                extend(idx, Dir::S, (maze.OpenDirsAt(next) & kSides & ~open) != 0);
+            }
+        }
+    }
+
+    // horizontal runs stop at cells whose vertical runs end at a jump point
+    auto verticalJump = [&](int idx) {
+        return ((at(idx, Dir::N) | at(idx, Dir::S)) & kJumpBit) != 0;
+    };
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const int idx = layout.Index({x, y});
+            if (maze.OpenDirsAt(idx) & DirBit(Dir::W)) {
+                extend(idx, Dir::W, verticalJump(layout.Step(idx, Dir::W)));
+            }
+        }
+        for (int x = w - 1; x >= 0; --x) {
+            const int idx = layout.Index({x, y});
+            if (maze.OpenDirsAt(idx) & DirBit(Dir::E)) {
+                extend(idx, Dir::E, verticalJump(layout.Step(idx, Dir::E)));
+            }
+        }
+    }
+}
+
+template <MazeGrid Grid>
+void JPSPathfinder::PrepareGrid(const Grid& maze) {
+    if (m_prepared.Update(maze)) BuildJumps(maze);
+}
+
+template <MazeGrid Grid>
+PathResult JPSPathfinder::Search(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    PathResult res;
+    const CellLayout& layout = maze.Layout();
+
+    if (!SearchableEnds(maze, start, goal)) {
+        res.found = false;
+        return res;
+    }
+
+    PrepareGrid(maze);
+
+    ws.Begin(layout.Count());
+
+    const int si = layout.Index(start);
+    const int gi = layout.Index(goal);
+    const Jumper jumper(m_jumps, layout, goal);
+
+    // a jump costs its length, so f = g + h stays a non-decreasing integer
+    BucketQueue<int>& open = ws.Buckets();
+    open.Reset(static_cast<size_t>(layout.Count()));
+    ws.Reach(si, -1, 0);
+    open.Push(si, Manhattan(start, goal));
+
+    while (!open.Empty()) {
+        const int ci = open.Pop();
+        const int g = ws.G(ci);
+        const CellPos pos = layout.Pos(ci);
+        ws.Close(ci);
+        res.expandedNodes++;
+
+        if (ci == gi) {
+            res.found = true;
+            // jump points are joined by straight runs; walk each one back
+            std::vector<CellPos> path;
+            int curi = ci;
+            while (ws.Prev(curi) != -1) {
+                const int from = ws.Prev(curi);
+                const CellPos a = layout.Pos(from);
+                const CellPos b = layout.Pos(curi);
+                const Dir back = b.x != a.x ? (b.x > a.x ? Dir::W : Dir::E) : (b.y > a.y ? Dir::N : Dir::S);
+                for (int i = curi; i != from; i = layout.Step(i, back)) path.push_back(layout.Pos(i));
+                curi = from;
+            }
+            path.push_back(start);
+            std::reverse(path.begin(), path.end());
+            res.path = std::move(path);
+            return res;
+        }
+
+        // the arrival direction is the straight run from the previous jump point
+        const int from = ws.Prev(ci);
+        Dir arrival = Dir::N;
+        if (from != -1) {
+            const CellPos a = layout.Pos(from);
+            arrival = pos.x != a.x ? (pos.x > a.x ? Dir::E : Dir::W) : (pos.y > a.y ? Dir::S : Dir::N);
+        }
+        for (uint8_t dirs = Successors(maze, ci, arrival, from == -1); dirs; dirs &= dirs - 1) {
+            const Dir d = FirstDir(dirs);
+            const int dist = jumper.Jump(ci, pos, d);
+            if (dist == 0) continue;
+            const DirDelta dd = Delta(d);
+            const CellPos nxt{pos.x + dd.dx * dist, pos.y + dd.dy * dist};
+            const int ni = layout.Index(nxt);
+            if (ws.Closed(ni)) continue;
+            const int tentativeG = g + dist;
+            if (tentativeG < ws.G(ni)) {
+                ws.Reach(ni, ci, tentativeG);
+                open.Push(ni, tentativeG + Manhattan(nxt, goal));
+            }
+        }
+    }
+
+    res.found = false;
+    return res;
+}
+
+void JPSPathfinder::Prepare(const Maze& maze) { PrepareGrid(maze); }
+void JPSPathfinder::Prepare(const MazeView& view) { PrepareGrid(view); }
+
+PathResult JPSPathfinder::FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return Search(maze, start, goal, ws);
+}
+
+PathResult JPSPathfinder::FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) {
+    return Search(view, start, goal, ws);
+}
+
+} // namespace ml
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "pathfinding/IPathfinder.h"
+
+namespace ml {
+
+// Jump Point Search for the 4-connected grid (JPS+: jump distances are
+// precomputed). Canonical shortest paths run horizontally and turn vertical
+// anywhere, but turn back to horizontal only where a side opening appears that
+// the previous cell did not have (a forced neighbour). A vertical run stops at
+// such a cell; a horizontal run stops at a cell whose vertical runs do. Only
+// those jump points enter the open list, so open caves expand a few nodes
+// where A* expands every tile. Path lengths match BFS; the path is expanded
+// back to tiles and expandedNodes counts jump points.
+// The jump table (4 words per tile) is rebuilt when the maze fingerprint changes.
+class JPSPathfinder final : public IPathfinder {
+public:
+    std::string Name() const override { return "JPS"; }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal) override {
+        return FindPath(maze, start, goal, m_workspace);
+    }
+    PathResult FindPath(const Maze& maze, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    void Prepare(const Maze& maze) override;
+    PathResult FindPath(const MazeView& view, CellPos start, CellPos goal, SearchWorkspace& ws) override;
+    void Prepare(const MazeView& view) override;
+
+private:
+    template <MazeGrid Grid> PathResult Search(const Grid& maze, CellPos start, CellPos goal, SearchWorkspace& ws);
+    template <MazeGrid Grid> void PrepareGrid(const Grid& maze);
+    template <MazeGrid Grid> void BuildJumps(const Grid& maze);
+
+    SearchWorkspace m_workspace;
+    // [CellLayout index * 4 + Dir]: steps to the next jump point (kJumpBit set)
+    // or to the last free tile before a wall, ignoring the goal.
+    std::vector<uint32_t> m_jumps;
+    PreparedMaze m_prepared;
+};
+
+} // namespace ml
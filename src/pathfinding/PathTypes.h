@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include "core/MazeGrid.h"
 #include "core/Types.h"
 
 namespace ml {
@@ -10,4 +11,11 @@ struct PathResult {
     int expandedNodes{0};
 };
 
+// Endpoints a per-tile search accepts: free tiles of a maze that has a cell
+// index space (Indexed()).
+template <MazeGrid Grid>
+bool SearchableEnds(const Grid& maze, CellPos start, CellPos goal) {
+    return maze.Indexed() && maze.InBounds(start) && maze.InBounds(goal) && !maze.IsWall(start) && !maze.IsWall(goal);
+}
+
 } // namespace ml
@@ -0,0 +1,24 @@
+#include "pathfinding/SearchWorkspace.h"
+#include <algorithm>
+
+namespace ml {
+
+void SearchWorkspace::Begin(int nodeCount) {
+    m_queue.clear();
+    const size_t n = static_cast<size_t>(std::max(nodeCount, 0));
+    if (n > m_slots.size()) {
+        m_slots.resize(n, Slot{0u, 0u, -1, kInf});
+    }
+    if (++m_epoch == 0) {
+        // wrapped: stamps of 2^32 queries ago would look current again
+        std::fill(m_slots.begin(), m_slots.end(), Slot{0u, 0u, -1, kInf});
+        m_epoch = 1;
+    }
+}
+
+SearchWorkspace& SearchWorkspace::Backward() {
+    if (!m_backward) m_backward = std::make_unique<SearchWorkspace>();
+    return *m_backward;
+}
+
+} // namespace ml
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "core/BucketQueue.h"
+
+namespace ml {
+
+// Per-node search state (prev, g, closed) reused across queries. A slot only
+// counts when its stamp equals the current epoch, so Begin() is O(1): the
+// arrays are cleared only when they grow or the 32-bit epoch wraps. A query
+// costs what it touches, not the maze size. One workspace per thread.
+class SearchWorkspace {
+public:
+    static constexpr int kInf = std::numeric_limits<int>::max() / 4;
+
+    // Starts a query over node indices [0, nodeCount) (CellLayout::Count()).
+    void Begin(int nodeCount);
+
+    bool Seen(int i) const noexcept { return m_slots[static_cast<size_t>(i)].stamp == m_epoch; }
+    int Prev(int i) const noexcept { return Seen(i) ? m_slots[static_cast<size_t>(i)].prev : -1; }
+    int G(int i) const noexcept { return Seen(i) ? m_slots[static_cast<size_t>(i)].g : kInf; }
+    bool Closed(int i) const noexcept { return m_slots[static_cast<size_t>(i)].closed == m_epoch; }
+
+    // Records (or improves) node i, reached from prev at cost g.
+    void Reach(int i, int prev, int g) noexcept {
+        Slot& s = m_slots[static_cast<size_t>(i)];
+        s.stamp = m_epoch;
+        s.prev = prev;
+        s.g = g;
+    }
+    void Close(int i) noexcept { m_slots[static_cast<size_t>(i)].closed = m_epoch; }
+
+    // Scratch FIFO for breadth-first searches, emptied by Begin().
+    std::vector<int>& Queue() noexcept { return m_queue; }
+    // Scratch open list for unit-cost best-first searches; call Reset() on it.
+    BucketQueue<int>& Buckets() noexcept { return m_buckets; }
+
+    int Capacity() const noexcept { return static_cast<int>(m_slots.size()); }
+
+    // Second workspace for searches run from both ends, created on first use
+    // and started separately (Backward().Begin(n)).
+    SearchWorkspace& Backward();
+
+private:
+    struct Slot {
+        uint32_t stamp;  // epoch in which prev/g were written
+        uint32_t closed; // epoch in which the node was closed
+        int prev;
+        int g;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<int> m_queue;
+    BucketQueue<int> m_buckets;
+    uint32_t m_epoch{0};
+    std::unique_ptr<SearchWorkspace> m_backward;
+};
+
+} // namespace ml
@@ -1,24 +1,64 @@
 #include "sim/Leaderboard.h"
 #include <fstream>
 #include <filesystem>
+#include <iomanip>
+#include <system_error>
 
 namespace ml {
 
+static constexpr const char* kHeader =
+    "timestamp,width,height,generator,visibility,agent,seed,random_seed,"
+    "status,steps,path_length,visited_unique,expanded_nodes,replans,duration_ms,maze_fingerprint";
+// Files written before maze_fingerprint was added.
+static constexpr const char* kHeaderNoFingerprint =
+    "timestamp,width,height,generator,visibility,agent,seed,random_seed,"
+    "status,steps,path_length,visited_unique,expanded_nodes,replans,duration_ms";
+
 Leaderboard::Leaderboard(std::string csvPath) : m_path(std::move(csvPath)) {}
 
 void Leaderboard::EnsureHeader() {
     if (m_headerWritten) return;
+    m_headerWritten = true;
 
-    const bool exists = std::filesystem::exists(m_path);
-    if (exists) {
-        m_headerWritten = true;
-        return;
+    std::string first;
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        if (in) std::getline(in, first);
     }
+    if (!first.empty() && first.back() == '\r') first.pop_back();
+    if (first == kHeader) return;
 
-    std::ofstream out(m_path, std::ios::binary);
-    out << "timestamp,width,height,generator,visibility,agent,seed,random_seed,"
-           "status,steps,path_length,visited_unique,expanded_nodes,replans,duration_ms\n";
-    m_headerWritten = true;
+    std::error_code ec;
+    if (first == kHeaderNoFingerprint && UpgradeNoFingerprint()) return;
+    if (!first.empty()) {
+        // unknown columns (or a failed upgrade): keep the old rows apart
+        std::filesystem::rename(m_path, m_path + ".old", ec);
+    }
+
+    std::ofstream out(m_path, std::ios::binary | std::ios::trunc);
+    out << kHeader << "\n";
+}
+
+bool Leaderboard::UpgradeNoFingerprint() {
+    // rewrite through a temporary file: new header, old rows with an empty fingerprint
+    const std::string tmp = m_path + ".tmp";
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!in || !out) return false;
+        std::string line;
+        std::getline(in, line); // old header
+        out << kHeader << "\n";
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) out << line << ",\n";
+        }
+        if (!out.flush()) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, m_path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
 }
 
 void Leaderboard::Append(const LeaderboardEntry& e) {
@@ -39,7 +79,8 @@ void Leaderboard::Append(const LeaderboardEntry& e) {
         << e.metrics.visited_unique << ","
         << e.metrics.expanded_nodes << ","
         << e.metrics.replans << ","
-        << e.metrics.duration_ms
+        << e.metrics.duration_ms << ","
+        << std::hex << std::setw(16) << std::setfill('0') << e.cfg.mazeFingerprint << std::dec
         << "\n";
 }
 
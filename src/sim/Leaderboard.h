@@ -12,6 +12,7 @@ struct RunConfigSnapshot {
     std::string agentName;
     uint32_t seed{1};
     bool randomSeed{false};
+    uint64_t mazeFingerprint{0}; // Maze::Fingerprint(), identifies the maze across runs
 };
 
 struct LeaderboardEntry {
@@ -31,7 +32,10 @@ public:
 private:
     std::string m_path;
     bool m_headerWritten{false};
+    // Writes the header to a new file, upgrades a file from before
+    // maze_fingerprint in place, and moves one with other columns to <path>.old.
     void EnsureHeader();
+    bool UpgradeNoFingerprint();
 };
 
 } // namespace ml
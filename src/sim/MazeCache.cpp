@@ -0,0 +1,53 @@
+#include "sim/MazeCache.h"
+
+namespace ml {
+
+const Maze* MazeCache::Find(const MazeCacheKey& key) {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        m_misses++;
+        return nullptr;
+    }
+    m_hits++;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return &it->second->maze;
+}
+
+void MazeCache::Insert(const MazeCacheKey& key, const Maze& maze) {
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_used -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    const size_t bytes = maze.MemoryBytes();
+    if (bytes > m_budget) return;
+    EvictToFit(bytes);
+
+    m_lru.push_front(Entry{key, maze, bytes});
+    m_index[key] = m_lru.begin();
+    m_used += bytes;
+}
+
+void MazeCache::Clear() {
+    m_lru.clear();
+    m_index.clear();
+    m_used = 0;
+}
+
+void MazeCache::SetBudget(size_t bytes) {
+    m_budget = bytes;
+    EvictToFit(0);
+}
+
+void MazeCache::EvictToFit(size_t incoming) {
+    while (!m_lru.empty() && m_used + incoming > m_budget) {
+        const Entry& last = m_lru.back();
+        m_used -= last.bytes;
+        m_index.erase(last.key);
+        m_lru.pop_back();
+    }
+}
+
+} // namespace ml
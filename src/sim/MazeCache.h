@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include "core/Maze.h"
+
+namespace ml {
+
+struct MazeCacheKey {
+    int generator{0};
+    int width{0};
+    int height{0};
+    uint32_t seed{0};
+    bool tiled{false};
+
+    bool operator==(const MazeCacheKey& o) const noexcept {
+        return generator == o.generator && width == o.width && height == o.height && seed == o.seed && tiled == o.tiled;
+    }
+};
+
+struct MazeCacheKeyHash {
+    size_t operator()(const MazeCacheKey& k) const noexcept {
+        uint64_t h = static_cast<uint64_t>(k.seed);
+        h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(k.width);
+        h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(k.height);
+        h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(k.generator);
+        h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(k.tiled);
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+// LRU cache of generated mazes, bounded by Maze::MemoryBytes() of the entries.
+// Only deterministic generations belong here (fixed seed, not randomSeed).
+class MazeCache {
+public:
+    explicit MazeCache(size_t budgetBytes = size_t{256} << 20) : m_budget(budgetBytes) {}
+
+    // Cached maze for key (and marks it most recently used), or nullptr.
+    const Maze* Find(const MazeCacheKey& key);
+    // Stores a copy; evicts least recently used entries to stay within budget.
+    // A maze larger than the whole budget is not cached.
+    void Insert(const MazeCacheKey& key, const Maze& maze);
+    void Clear();
+
+    void SetBudget(size_t bytes);
+    size_t Budget() const noexcept { return m_budget; }
+    size_t UsedBytes() const noexcept { return m_used; }
+    size_t Size() const noexcept { return m_lru.size(); }
+
+    uint64_t Hits() const noexcept { return m_hits; }
+    uint64_t Misses() const noexcept { return m_misses; }
+
+private:
+    struct Entry {
+        MazeCacheKey key;
+        Maze maze;
+        size_t bytes{0};
+    };
+
+    void EvictToFit(size_t incoming);
+
+    std::list<Entry> m_lru; // front = most recently used
+    std::unordered_map<MazeCacheKey, std::list<Entry>::iterator, MazeCacheKeyHash> m_index;
+    size_t m_budget{0};
+    size_t m_used{0};
+    uint64_t m_hits{0};
+    uint64_t m_misses{0};
+};
+
+} // namespace ml
@@ -1,10 +1,16 @@
 #include "sim/Simulation.h"
+#include "core/MazeComponents.h"
+#include "core/MazeFile.h"
 
 #include "generators/RecursiveBacktrackerGenerator.h"
 #include "generators/PrimGenerator.h"
 #include "generators/CellularAutomataGenerator.h"
+#include "generators/EllerGenerator.h"
+#include "generators/KruskalGenerator.h"
 
-#include "pathfinding/BFSPathfinder.h"
+#include "pathfinding/PathTypes.h"
+#include "pathfinding/DistanceField.h"
+#include "pathfinding/DeadEndFilling.h"
 
 #include "agents/BFSAgent.h"
 #include "agents/AStarAgent.h"
@@ -20,32 +26,25 @@
 namespace ml {
 
 static int MakeOddSize(int v) {
-    v = std::clamp(v, 10, 200);
+    v = std::clamp(v, kMinMazeSide - 1, kMaxMazeSide + 1);
     if (v % 2 == 0) {
-        if (v < 200) v += 1;
+        if (v < kMaxMazeSide + 1) v += 1;
         else v -= 1;
     }
-    return std::clamp(v, 11, 199); // keep inside and odd
+    return std::clamp(v, kMinMazeSide, kMaxMazeSide); // keep inside and odd
 }
 
 int SimEnvironmentFull::Width() const { return m_maze ? m_maze->Width() : 0; }
 int SimEnvironmentFull::Height() const { return m_maze ? m_maze->Height() : 0; }
 
 Sense4 SimEnvironmentFull::SenseWalls4(CellPos at) const {
-    Sense4 s{};
-    if (!m_maze) return s;
-    s.n = m_maze->IsWall({at.x, at.y-1});
-    s.e = m_maze->IsWall({at.x+1, at.y});
-    s.s = m_maze->IsWall({at.x, at.y+1});
-    s.w = m_maze->IsWall({at.x-1, at.y});
-    return s;
+    if (!m_maze) return Sense4{};
+    return SenseFromOpenDirs(m_maze->OpenDirs(at));
 }
 
 bool SimEnvironmentFull::TryMove(CellPos from, Dir dir, CellPos& outNewPos) const {
-    if (!m_maze) return false;
-    CellPos to = m_maze->Step(from, dir);
-    if (!m_maze->InBounds(to) || m_maze->IsWall(to)) return false;
-    outNewPos = to;
+    if (!m_maze || !m_maze->CanMove(from, dir)) return false;
+    outNewPos = m_maze->Step(from, dir);
     return true;
 }
 
@@ -56,20 +55,13 @@ int SimEnvironmentPartial::Width() const { return m_maze ? m_maze->Width() : 0;
 int SimEnvironmentPartial::Height() const { return m_maze ? m_maze->Height() : 0; }
 
 Sense4 SimEnvironmentPartial::SenseWalls4(CellPos at) const {
-    Sense4 s{};
-    if (!m_maze) return s;
-    s.n = m_maze->IsWall({at.x, at.y-1});
-    s.e = m_maze->IsWall({at.x+1, at.y});
-    s.s = m_maze->IsWall({at.x, at.y+1});
-    s.w = m_maze->IsWall({at.x-1, at.y});
-    return s;
+    if (!m_maze) return Sense4{};
+    return SenseFromOpenDirs(m_maze->OpenDirs(at));
 }
 
 bool SimEnvironmentPartial::TryMove(CellPos from, Dir dir, CellPos& outNewPos) const {
-    if (!m_maze) return false;
-    CellPos to = m_maze->Step(from, dir);
-    if (!m_maze->InBounds(to) || m_maze->IsWall(to)) return false;
-    outNewPos = to;
+    if (!m_maze || !m_maze->CanMove(from, dir)) return false;
+    outNewPos = m_maze->Step(from, dir);
     return true;
 }
 
@@ -77,8 +69,11 @@ Simulation::Simulation()
     : m_genDFS(std::make_unique<RecursiveBacktrackerGenerator>())
     , m_genPrim(std::make_unique<PrimGenerator>())
     , m_genCellular(std::make_unique<CellularAutomataGenerator>())
+    , m_genEller(std::make_unique<EllerGenerator>())
+    , m_genKruskal(std::make_unique<KruskalGenerator>())
     , m_envFull(&m_maze, m_exit)
     , m_envPartial(&m_maze, m_exit)
+    , m_envPruned(&m_solution, m_exit)
 {
     m_cfg.width = 51;
     m_cfg.height = 51;
@@ -95,29 +90,139 @@ void Simulation::SetTicksPerFrame(int t) {
     m_ticksPerFrame = std::clamp(t, 1, 50);
 }
 
+IMazeGenerator& Simulation::ActiveGenerator() {
+    if (m_cfg.generatorIndex == 0) return *m_genDFS;
+    if (m_cfg.generatorIndex == 1) return *m_genPrim;
+    if (m_cfg.generatorIndex == 2) return *m_genCellular;
+    if (m_cfg.generatorIndex == 3) return *m_genEller;
+    return *m_genKruskal;
+}
+
 void Simulation::GenerateMaze() {
+    BeginGenerateMaze();
+    while (!StepGeneration(1e9)) {}
+}
+
+void Simulation::BeginGenerateMaze() {
+    CancelGeneration();
+    m_running = false;
+    m_paused = false;
+
     m_cfg.width = MakeOddSize(m_cfg.width);
     m_cfg.height = MakeOddSize(m_cfg.height);
 
-    m_start = {1,1};
-    m_exit = {m_cfg.width - 2, m_cfg.height - 2};
-
     MazeGenConfig gc;
     gc.width = m_cfg.width;
     gc.height = m_cfg.height;
     gc.seed = m_cfg.seed;
     gc.randomSeed = m_cfg.randomSeed;
-    gc.start = m_start;
-    gc.exit = m_exit;
+    gc.start = {1,1};
+    gc.exit = {m_cfg.width - 2, m_cfg.height - 2};
+    gc.tiled = m_cfg.tiledGeneration && (m_cfg.generatorIndex == 0 || m_cfg.generatorIndex == 1);
+    m_genCfg = gc;
+
+    m_genKey = MazeCacheKey{m_cfg.generatorIndex, m_cfg.width, m_cfg.height, m_cfg.seed, gc.tiled};
+    if (!m_cfg.randomSeed) {
+        if (const Maze* cached = m_mazeCache.Find(m_genKey)) {
+            m_start = gc.start;
+            m_exit = gc.exit;
+            m_maze = *cached;
+            OnMazeReplaced();
+            m_genInstalled = true;
+            return;
+        }
+    }
 
-    if (m_cfg.generatorIndex == 0) {
-        m_genDFS->Generate(m_maze, gc);
-    } else if (m_cfg.generatorIndex == 1) {
-        m_genPrim->Generate(m_maze, gc);
-    } else {
-        m_genCellular->Generate(m_maze, gc);
+    m_genTask = ActiveGenerator().Begin(gc);
+
+    // Redrawing the partial maze costs a full rasterization per slice; skip it for huge mazes.
+    constexpr long long kMaxPreviewTiles = 1 << 21;
+    m_genPreview = m_cfg.animateGeneration &&
+        static_cast<long long>(gc.width) * gc.height <= kMaxPreviewTiles;
+    if (m_genPreview) m_genBackup = m_maze;
+}
+
+bool Simulation::StepGeneration(double budgetMs) {
+    if (m_genInstalled) {
+        m_genInstalled = false;
+        return true;
     }
+    if (!m_genTask) return false;
+
+    // Work in small fixed budgets until the time slice is used up.
+    constexpr long long kStepBudget = 1 << 14;
+    const auto t0 = std::chrono::steady_clock::now();
+    bool done = false;
+    do {
+        done = m_genTask->Step(kStepBudget);
+    } while (!done && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() < budgetMs);
+
+    if (!done) {
+        if (m_genPreview) m_genTask->Preview(m_maze);
+        return false;
+    }
+    InstallGeneratedMaze();
+    return true;
+}
+
+void Simulation::InstallGeneratedMaze() {
+    m_start = m_genCfg.start;
+    m_exit = m_genCfg.exit;
+    m_genTask->Finish(m_maze);
+    m_genTask.reset();
+    m_genPreview = false;
+    m_genBackup = Maze{};
+
+    OnMazeReplaced();
+    if (!m_cfg.randomSeed) m_mazeCache.Insert(m_genKey, m_maze);
+}
+
+void Simulation::CancelGeneration() {
+    if (m_genPreview) m_maze = std::move(m_genBackup);
+    m_genBackup = Maze{};
+    m_genTask.reset();
+    m_genPreview = false;
+    m_genInstalled = false;
+}
 
+float Simulation::GenerationProgress() const noexcept {
+    if (m_genTask) return m_genTask->Progress();
+    return m_genInstalled ? 1.0f : 0.0f;
+}
+
+bool Simulation::SaveMazeFile(const std::string& path) const {
+    MazeMeta meta;
+    meta.start = m_start;
+    meta.exit = m_exit;
+    meta.generator = static_cast<uint32_t>(m_cfg.generatorIndex);
+    meta.seed = m_cfg.seed;
+    return SaveMazeBinary(path, m_maze, meta);
+}
+
+bool Simulation::LoadMazeFile(const std::string& path) {
+    MazeView view;
+    if (!view.Open(path)) return false;
+    if (view.Width() > kMaxMazeSide || view.Height() > kMaxMazeSide) return false;
+    if (!view.InBounds(view.Meta().start) || !view.InBounds(view.Meta().exit)) return false;
+
+    CancelGeneration();
+    m_running = false;
+    m_paused = false;
+    view.CopyTo(m_maze);
+
+    m_cfg.width = view.Width();
+    m_cfg.height = view.Height();
+    m_cfg.generatorIndex = std::clamp(static_cast<int>(view.Meta().generator), 0, 4);
+    m_cfg.seed = static_cast<uint32_t>(view.Meta().seed);
+    m_cfg.randomSeed = false;
+    m_start = view.Meta().start;
+    m_exit = view.Meta().exit;
+
+    OnMazeReplaced();
+    return true;
+}
+
+void Simulation::OnMazeReplaced() {
     // reset shortest-path overlay on new maze
     m_shortestPathMask.clear();
 
@@ -130,7 +235,18 @@ void Simulation::GenerateMaze() {
     m_envFull.SetExit(m_exit);
     m_envPartial.SetExit(m_exit);
 
-    m_stepLimit = m_maze.Width() * m_maze.Height() * 20;
+    m_stepLimit = static_cast<long long>(m_maze.Width()) * m_maze.Height() * 20;
+}
+
+const Maze& Simulation::SolutionMaze() {
+    const uint64_t fp = m_maze.Fingerprint();
+    if (fp != m_solutionFingerprint || m_start != m_solutionStart || m_exit != m_solutionExit) {
+        m_solution = FillDeadEnds(m_maze, m_start, m_exit);
+        m_solutionFingerprint = fp;
+        m_solutionStart = m_start;
+        m_solutionExit = m_exit;
+    }
+    return m_solution;
 }
 
 void Simulation::BuildAgent() {
@@ -143,12 +259,20 @@ void Simulation::BuildAgent() {
         if (m_cfg.agentIndex == 0 || m_cfg.agentIndex == 1) m_cfg.agentIndex = 2;
     }
 
+    // Searching agents may plan on the dead-end filled maze; their moves stay legal in the real one.
+    SimEnvironmentFull* searchEnv = &m_envFull;
+    if (m_cfg.prunedSearch && (m_cfg.agentIndex == 0 || m_cfg.agentIndex == 1)) {
+        SolutionMaze();
+        m_envPruned.SetExit(m_exit);
+        searchEnv = &m_envPruned;
+    }
+
     switch (m_cfg.agentIndex) {
     case 0: // BFS
-        m_agent = std::make_unique<BFSAgent>(&m_envFull);
+        m_agent = std::make_unique<BFSAgent>(searchEnv);
         break;
     case 1: // A*
-        m_agent = std::make_unique<AStarAgent>(&m_envFull);
+        m_agent = std::make_unique<AStarAgent>(searchEnv);
         break;
     case 2: // Right-hand
         m_agent = std::make_unique<RightHandAgent>(&m_envPartial);
@@ -181,6 +305,7 @@ void Simulation::ResetAgent() {
 }
 
 void Simulation::Start() {
+    if (IsGenerating()) return;
     if (!m_agent) BuildAgent();
     if (!m_agent) return;
     m_running = true;
@@ -190,6 +315,12 @@ void Simulation::Start() {
     m_agent->Reset(m_start, m_exit);
     m_agent->Start();
     m_runStart = std::chrono::steady_clock::now();
+
+    // Exit in another component: fail now instead of ticking up to m_stepLimit.
+    if (!m_maze.Components().Connected(m_start, m_exit)) {
+        m_agent->RequestStopFail();
+        FinishIfNeeded();
+    }
 }
 
 void Simulation::PauseToggle() {
@@ -198,6 +329,7 @@ void Simulation::PauseToggle() {
 }
 
 void Simulation::StepOnce() {
+    if (IsGenerating()) return;
     if (!m_running) {
         // allow single-step by auto-starting
         Start();
@@ -242,15 +374,21 @@ void Simulation::FinishIfNeeded() {
 
     // compute shortest path overlay when the agent succeeds
     if (m_agent->Status() == AgentStatus::Success) {
-        BFSPathfinder bfs;
-        auto r = bfs.FindPath(m_maze, m_start, m_exit);
+        // Perfect mazes fill down to the path itself; otherwise search the (smaller) filled maze.
+        const Maze& solution = SolutionMaze();
+        PathResult r;
+        r.found = TraceSinglePath(solution, m_start, m_exit, r.path);
+        if (!r.found) {
+            DistanceField field;
+            field.Build(solution, m_start);
+            r.found = field.PathToSource(solution, m_exit, r.path);
+        }
         if (r.found) {
-            const int w = m_maze.Width();
-            const int h = m_maze.Height();
-            m_shortestPathMask.assign(static_cast<size_t>(w * h), 0u);
+            const CellLayout& layout = m_maze.Layout();
+            m_shortestPathMask.assign(static_cast<size_t>(layout.Count()), 0u);
             for (const auto& p : r.path) {
                 if (m_maze.InBounds(p)) {
-                    m_shortestPathMask[static_cast<size_t>(ToIndex(p.x, p.y, w))] = 1u;
+                    m_shortestPathMask[static_cast<size_t>(layout.Index(p))] = 1u;
                 }
             }
         } else {
@@ -287,11 +425,15 @@ LeaderboardEntry Simulation::MakeLeaderboardEntry() const {
     snap.height = m_cfg.height;
     if (m_cfg.generatorIndex == 0) snap.generator = "DFS";
     else if (m_cfg.generatorIndex == 1) snap.generator = "Prim";
-    else snap.generator = "Cellular";
+    else if (m_cfg.generatorIndex == 2) snap.generator = "Cellular";
+    else if (m_cfg.generatorIndex == 3) snap.generator = "Eller";
+    else snap.generator = "Kruskal";
+    if (m_cfg.tiledGeneration && m_cfg.generatorIndex <= 1) snap.generator += " (tiled)";
     snap.visibilityMode = (m_cfg.visibility == VisibilityMode::Full) ? "Full" : "Partial";
     snap.agentName = m_agent ? m_agent->Name() : std::string{};
     snap.seed = m_cfg.seed;
     snap.randomSeed = m_cfg.randomSeed;
+    snap.mazeFingerprint = m_maze.Fingerprint();
 
     LeaderboardEntry e;
     e.timestampIso = oss.str();
@@ -307,7 +449,7 @@ bool Simulation::SaveSnapshotToLeaderboard() {
 }
 
 void Simulation::ManualRightClick(CellPos target) {
-    if (!m_agent) return;
+    if (!m_agent || IsGenerating()) return;
     // Only manual supports it; safe cast
     if (auto* man = dynamic_cast<ManualAgent*>(m_agent.get())) {
         man->OnRightClick(target);
@@ -10,19 +10,29 @@
 #include "agents/Environment.h"
 #include "agents/IAgent.h"
 #include "sim/Leaderboard.h"
+#include "sim/MazeCache.h"
 
 namespace ml {
 
 enum class VisibilityMode : uint8_t { Full, Partial };
 
+// Maze side limits (odd) for the interactive simulation. Maze storage is sparse
+// and goes to Maze::kMaxSide, but agent masks, the path overlay and the
+// per-tile searches are dense per cell, so a run is kept to what they can hold.
+inline constexpr int kMinMazeSide = 11;
+inline constexpr int kMaxMazeSide = 16383;
+
 struct SimConfig {
     int width{31};
     int height{31};
     uint32_t seed{1};
     bool randomSeed{false};
-    int generatorIndex{0}; // 0=DFS, 1=Prim, 2=CellularAutomata
+    int generatorIndex{0}; // 0=DFS, 1=Prim, 2=CellularAutomata, 3=Eller, 4=Kruskal
     VisibilityMode visibility{VisibilityMode::Full};
     int agentIndex{0}; // 0=BFS,1=A*,2=Right,3=Frontier,4=Manual
+    bool tiledGeneration{false}; // DFS/Prim: tile-parallel mode (MazeGenConfig::tiled)
+    bool prunedSearch{false}; // BFS/A* agents search the dead-end filled maze (SolutionMaze)
+    bool animateGeneration{false}; // show the partial maze while a sliced generation runs
 };
 
 class SimEnvironmentFull final : public IFullEnvironment {
@@ -82,8 +92,27 @@ public:
     int TicksPerFrame() const noexcept { return m_ticksPerFrame; }
     void SetTicksPerFrame(int t);
 
+    // Fixed-seed generations are served from the maze cache when possible.
     void GenerateMaze();
+
+    // Time-sliced generation: BeginGenerateMaze() sets up a generator task and
+    // each StepGeneration() call carves for about budgetMs. It returns true on
+    // the call that installs the finished maze (then call ResetAgent()); cache
+    // hits install in BeginGenerateMaze() and return true from the next call.
+    // CancelGeneration() keeps the previous maze. Agents are held meanwhile.
+    void BeginGenerateMaze();
+    bool StepGeneration(double budgetMs);
+    void CancelGeneration();
+    bool IsGenerating() const noexcept { return m_genTask != nullptr || m_genInstalled; }
+    float GenerationProgress() const noexcept;
     void ResetAgent();
+
+    // Binary maze files (.mlzb, see core/MazeFile.h). Load replaces the maze,
+    // start/exit, size, generator and seed; call ResetAgent() afterwards. A run
+    // carves start/exit and may edit tiles, so Load copies the mapped rows into
+    // the Maze; read-only users (pathfinders, FindPaths) can query a MazeView.
+    bool SaveMazeFile(const std::string& path) const;
+    bool LoadMazeFile(const std::string& path);
     void Start();
     void PauseToggle();
     void StepOnce();
@@ -91,6 +120,17 @@ public:
 
     void TickMany(int ticks);
 
+    // Dead-end filled copy of the maze for the current start/exit (see
+    // pathfinding/DeadEndFilling.h), rebuilt when the maze fingerprint changes.
+    const Maze& SolutionMaze();
+
+    MazeCache& GetMazeCache() noexcept { return m_mazeCache; }
+    const MazeCache& GetMazeCache() const noexcept { return m_mazeCache; }
+
+    // Current start/exit tiles (from the generator config or a loaded file).
+    CellPos GetStart() const noexcept { return m_start; }
+    CellPos GetExit() const noexcept { return m_exit; }
+
     // UI: shortest path highlight (computed when agent finishes SUCCESS)
     const std::vector<uint8_t>& ShortestPathMask() const noexcept { return m_shortestPathMask; }
     bool ShouldDrawShortestPath() const noexcept;
@@ -114,6 +154,9 @@ private:
     LeaderboardEntry MakeLeaderboardEntry() const;
     void BuildAgent();
     void FinishIfNeeded();
+    void OnMazeReplaced();
+    IMazeGenerator& ActiveGenerator();
+    void InstallGeneratedMaze();
 
 private:
     Maze m_maze;
@@ -122,12 +165,29 @@ private:
     std::unique_ptr<IMazeGenerator> m_genDFS;
     std::unique_ptr<IMazeGenerator> m_genPrim;
     std::unique_ptr<IMazeGenerator> m_genCellular;
+    std::unique_ptr<IMazeGenerator> m_genEller;
+    std::unique_ptr<IMazeGenerator> m_genKruskal;
+    MazeCache m_mazeCache;
+
+    // pending sliced generation (BeginGenerateMaze)
+    std::unique_ptr<IGenTask> m_genTask;
+    MazeGenConfig m_genCfg;
+    MazeCacheKey m_genKey{};
+    bool m_genInstalled{false}; // cache hit waiting for its StepGeneration() call
+    bool m_genPreview{false};   // m_maze shows the partial maze, m_genBackup the old one
+    Maze m_genBackup;
 
     CellPos m_start{1,1};
     CellPos m_exit{1,1};
 
     SimEnvironmentFull m_envFull;
     SimEnvironmentPartial m_envPartial;
+    SimEnvironmentFull m_envPruned; // over m_solution
+
+    Maze m_solution;
+    uint64_t m_solutionFingerprint{0};
+    CellPos m_solutionStart{-1,-1};
+    CellPos m_solutionExit{-1,-1};
 
     std::unique_ptr<IAgent> m_agent;
 
@@ -135,12 +195,12 @@ private:
     bool m_paused{false};
 
     int m_ticksPerFrame{1};
-    int m_stepLimit{0};
-    int m_totalTicks{0};
+    long long m_stepLimit{0};
+    long long m_totalTicks{0};
 
     std::shared_ptr<Leaderboard> m_leaderboard;
 
-    // shortest path overlay (mask of tiles)
+    // shortest path overlay (mask of tiles, CellLayout indexed)
     std::vector<uint8_t> m_shortestPathMask;
 
     // duration accounting (logic-only)
@@ -24,13 +24,15 @@ App::App() {
     m_sim.AttachLeaderboard(std::make_shared<ml::Leaderboard>("leaderboard.csv"));
 
     // Defaults
-    m_wStep.label = "W"; m_wStep.min = 10; m_wStep.max = 200; m_wStep.value = m_sim.GetConfig().width;
-    m_hStep.label = "H"; m_hStep.min = 10; m_hStep.max = 200; m_hStep.value = m_sim.GetConfig().height;
+    m_wStep.label = "W"; m_wStep.min = 10; m_wStep.max = ml::kMaxMazeSide; m_wStep.value = m_sim.GetConfig().width;
+    m_hStep.label = "H"; m_hStep.min = 10; m_hStep.max = ml::kMaxMazeSide; m_hStep.value = m_sim.GetConfig().height;
     m_seedStep.label = "Seed"; m_seedStep.min = 0; m_seedStep.max = 999999; m_seedStep.value = (int)m_sim.GetConfig().seed;
     m_randomSeed.label = "Random seed"; m_randomSeed.value = m_sim.GetConfig().randomSeed;
+    m_animateGen.label = "Animate"; m_animateGen.value = m_sim.GetConfig().animateGeneration;
+    m_tiledGen.label = "Tiled"; m_tiledGen.value = m_sim.GetConfig().tiledGeneration;
 
     m_genSel.label = "Generator";
-    m_genSel.SetItems({"DFS", "Prim", "Cellular"});
+    m_genSel.SetItems({"DFS", "Prim", "Cellular", "Eller", "Kruskal"});
     m_genSel.selected = m_sim.GetConfig().generatorIndex;
 
     m_visSel.label = "Visibility";
@@ -57,10 +59,14 @@ App::App() {
     m_speed.value = m_sim.TicksPerFrame();
 
     // Wiring
+    // Generation runs a slice per frame (see Run); clicking again cancels it.
     m_btnGenerate.onClick = [&] {
+        if (m_sim.IsGenerating()) {
+            m_sim.CancelGeneration();
+            return;
+        }
         SyncSimToUI();
-        m_sim.GenerateMaze();
-        m_sim.ResetAgent();
+        m_sim.BeginGenerateMaze();
     };
     m_btnStart.onClick = [&] {
         SyncSimToUI();
@@ -205,8 +211,11 @@ void App::LayoutUIForTarget(const sf::Vector2u& targetSize, bool detached) {
     m_seedStep.rect = row(full);
     nextLine();
 
-    // Random seed toggle
-    m_randomSeed.rect = row(full);
+    // Random seed / animated / tiled (DFS, Prim) generation toggles
+    const float toggleW = (full - 2.f * gap) / 3.f;
+    m_randomSeed.rect = row(toggleW + 24.f);
+    m_animateGen.rect = row(toggleW - 12.f);
+    m_tiledGen.rect = row(toggleW - 12.f);
     nextLine();
 
     // Generator/Visibility/Agent
@@ -240,6 +249,8 @@ void App::SyncSimToUI() {
     cfg.height = m_hStep.value;
     cfg.seed = (uint32_t)std::max(0, m_seedStep.value);
     cfg.randomSeed = m_randomSeed.value;
+    cfg.animateGeneration = m_animateGen.value;
+    cfg.tiledGeneration = m_tiledGen.value;
     cfg.generatorIndex = m_genSel.selected;
     cfg.visibility = (m_visSel.selected == 0) ? ml::VisibilityMode::Full : ml::VisibilityMode::Partial;
     if (!m_agentIds.empty() && m_agentSel.selected >= 0 && m_agentSel.selected < (int)m_agentIds.size()) {
@@ -254,6 +265,8 @@ void App::SyncUIToSim() {
     m_hStep.value = cfg.height;
     m_seedStep.value = (int)cfg.seed;
     m_randomSeed.value = cfg.randomSeed;
+    m_animateGen.value = cfg.animateGeneration;
+    m_tiledGen.value = cfg.tiledGeneration;
     m_genSel.selected = cfg.generatorIndex;
     m_visSel.selected = (cfg.visibility == ml::VisibilityMode::Full) ? 0 : 1;
     RefreshAgentSelector();
@@ -313,6 +326,8 @@ void App::HandlePanelEvent(const sf::Event& e) {
     m_hStep.Handle(e, mouse);
     m_seedStep.Handle(e, mouse);
     m_randomSeed.Handle(e, mouse);
+    m_animateGen.Handle(e, mouse);
+    m_tiledGen.Handle(e, mouse);
 
     int prevVis = m_visSel.selected;
     m_genSel.Handle(e, mouse);
@@ -364,6 +379,20 @@ void App::HandleEvent(const sf::Event& e) {
             if (kp->code == sf::Keyboard::Key::S && (kp->control)) {
                 if (m_btnSaveCsv.onClick) m_btnSaveCsv.onClick();
             }
+            if (kp->code == sf::Keyboard::Key::F5) {
+                m_toast = m_sim.SaveMazeFile("maze.mlzb") ? "Saved maze.mlzb" : "Failed to save maze.mlzb";
+                m_toastTimer = 2.0f;
+            }
+            if (kp->code == sf::Keyboard::Key::F9) {
+                if (m_sim.LoadMazeFile("maze.mlzb")) {
+                    SyncUIToSim();
+                    m_sim.ResetAgent();
+                    m_toast = "Loaded maze.mlzb";
+                } else {
+                    m_toast = "Failed to load maze.mlzb";
+                }
+                m_toastTimer = 2.0f;
+            }
         }
     }
 
@@ -462,6 +491,8 @@ void App::HandleEvent(const sf::Event& e) {
         }
         if (overPanel) {
             m_randomSeed.Handle(e, mouse);
+            m_animateGen.Handle(e, mouse);
+            m_tiledGen.Handle(e, mouse);
 
             int prevVis = m_visSel.selected;
             m_genSel.Handle(e, mouse);
@@ -535,11 +566,14 @@ void App::DrawPanel(sf::RenderTarget& rt, const sf::Vector2u& targetSize, bool d
     m_hStep.Draw(rt, font, m_style);
     m_seedStep.Draw(rt, font, m_style);
     m_randomSeed.Draw(rt, font, m_style);
+    m_animateGen.Draw(rt, font, m_style);
+    m_tiledGen.Draw(rt, font, m_style);
 
     m_genSel.Draw(rt, font, m_style);
     m_visSel.Draw(rt, font, m_style);
     m_agentSel.Draw(rt, font, m_style);
 
+    m_btnGenerate.label = m_sim.IsGenerating() ? "Cancel" : "Generate";
     m_btnGenerate.Draw(rt, font, m_style);
     m_btnStart.Draw(rt, font, m_style);
     m_btnPause.Draw(rt, font, m_style);
@@ -552,6 +586,9 @@ void App::DrawPanel(sf::RenderTarget& rt, const sf::Vector2u& targetSize, bool d
     // status + toast
     auto* ag = m_sim.ActiveAgent();
     std::string status = ag ? std::string(ToString(ag->Status())) : "N/A";
+    if (m_sim.IsGenerating()) {
+        status = "Generating " + std::to_string((int)(m_sim.GenerationProgress() * 100.f)) + "%";
+    }
     std::string line = "Agent: " + m_sim.ActiveAgentName() + " | Status: " + status +
                        "\nsteps: " + std::to_string(ag ? ag->Metrics().steps : 0) +
                        " | visited: " + std::to_string(ag ? ag->Metrics().visited_unique : 0) +
@@ -595,6 +632,14 @@ void App::Run() {
         // sync speed
         m_sim.SetTicksPerFrame(m_speed.value);
 
+        // pending generation gets a fixed slice of each frame
+        if (m_sim.IsGenerating()) {
+            constexpr double generationBudgetMs = 8.0;
+            if (m_sim.StepGeneration(generationBudgetMs)) {
+                m_sim.ResetAgent();
+            }
+        }
+
         // run simulation ticks (time-based, independent from FPS)
         if (m_sim.IsRunning() && !m_sim.IsPaused()) {
             // Previously x1 roughly matched "1 tick per frame" with vsync (~60 tps).
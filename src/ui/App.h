@@ -39,6 +39,8 @@ private:
     StepperInt m_hStep;
     StepperInt m_seedStep;
     Toggle m_randomSeed;
+    Toggle m_animateGen;
+    Toggle m_tiledGen;
 
     CycleSelector m_genSel;
     CycleSelector m_visSel;
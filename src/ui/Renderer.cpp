@@ -16,26 +16,45 @@ ml::CellPos Renderer::WorldToCell(sf::Vector2f world, const Simulation& sim) con
 }
 
 void Renderer::Draw(sf::RenderTarget& rt, const Simulation& sim, const sf::View& view, bool partialShading) const {
-    (void)view;
-
     const auto& maze = sim.GetMaze();
     const int w = maze.Width();
     const int h = maze.Height();
 
+    const ml::CellLayout& layout = maze.Layout();
+
+    // Masks are CellLayout indexed; one sized for another maze (agent not reset yet) is ignored.
+    static const std::vector<uint8_t> kNoMask;
     const ml::IAgent* agent = sim.ActiveAgent();
-    const auto& visited = agent ? agent->VisitedMask() : std::vector<uint8_t>();
-    const auto& frontier = agent ? agent->FrontierMask() : std::vector<uint8_t>();
+    const bool masksMatch = agent && agent->VisitedMask().size() == (size_t)layout.Count();
+    const auto& visited = masksMatch ? agent->VisitedMask() : kNoMask;
+    const auto& frontier = (masksMatch && agent->FrontierMask().size() == visited.size()) ? agent->FrontierMask() : kNoMask;
+
+    // Only the cells inside the view are drawn (mazes can be far bigger than the screen).
+    const sf::Vector2f vc = view.getCenter();
+    const sf::Vector2f vs = view.getSize();
+    const int cx0 = std::clamp((int)std::floor((vc.x - vs.x * 0.5f) / m_tile), 0, w);
+    const int cy0 = std::clamp((int)std::floor((vc.y - vs.y * 0.5f) / m_tile), 0, h);
+    const int cx1 = std::clamp((int)std::ceil((vc.x + vs.x * 0.5f) / m_tile), 0, w);
+    const int cy1 = std::clamp((int)std::ceil((vc.y + vs.y * 0.5f) / m_tile), 0, h);
+
+    // Zoomed far out: sample one cell per stride x stride block to bound the vertex count.
+    constexpr long long kMaxDrawnTiles = 1 << 18;
+    const long long visibleTiles = (long long)(cx1 - cx0) * (long long)(cy1 - cy0);
+    int stride = 1;
+    while (visibleTiles / ((long long)stride * stride) > kMaxDrawnTiles) stride *= 2;
+    const int sx0 = cx0 - cx0 % stride;
+    const int sy0 = cy0 - cy0 % stride;
 
     // Use vertex array for tiles (fast)
     sf::VertexArray va(sf::PrimitiveType::Triangles);
-    va.resize((size_t)w * (size_t)h * 6);
+    const size_t cols = (size_t)((cx1 - sx0 + stride - 1) / stride);
+    const size_t rows = (size_t)((cy1 - sy0 + stride - 1) / stride);
+    va.resize(cols * rows * 6);
 
-    auto tileColor = [&](int x, int y) -> sf::Color {
-        ml::CellPos p{x,y};
-        bool wall = maze.IsWall(p);
+    auto tileColor = [&](int x, int y, bool wall) -> sf::Color {
         sf::Color c = wall ? sf::Color(40,40,40) : sf::Color(95,95,95);
 
-        int idx = ml::ToIndex(x,y,w);
+        int idx = layout.Index({x,y});
         if (!wall && agent) {
             if (!frontier.empty() && frontier[(size_t)idx]) c = sf::Color(120,120,255);
             if (!visited.empty() && visited[(size_t)idx]) c = sf::Color(180,180,180);
@@ -53,14 +72,23 @@ void Renderer::Draw(sf::RenderTarget& rt, const Simulation& sim, const sf::View&
     };
 
     size_t v = 0;
-    for (int y = 0; y < h; ++y) {
-        for (int x = 0; x < w; ++x) {
+    for (int y = sy0; y < cy1; y += stride) {
+        uint64_t freeBits = 0u;
+        int word = -1;
+        for (int x = sx0; x < cx1; x += stride) {
+            // walls come from the bit-packed rows, one word per 64 tiles
+            if ((x >> 6) != word) {
+                word = x >> 6;
+                freeBits = maze.RowWord(y, word);
+            }
+            const bool wall = ((freeBits >> (x & 63)) & 1u) == 0;
+
             float x0 = x * m_tile;
             float y0 = y * m_tile;
-            float x1 = x0 + m_tile;
-            float y1 = y0 + m_tile;
+            float x1 = std::min(x + stride, w) * m_tile;
+            float y1 = std::min(y + stride, h) * m_tile;
 
-            sf::Color c = tileColor(x,y);
+            sf::Color c = tileColor(x,y,wall);
 
             // two triangles
             va[v + 0] = sf::Vertex({x0,y0}, c);
@@ -78,21 +106,21 @@ void Renderer::Draw(sf::RenderTarget& rt, const Simulation& sim, const sf::View&
     // Shortest path overlay (shown after success)
     if (sim.ShouldDrawShortestPath()) {
         const auto& mask = sim.ShortestPathMask();
-        if (!mask.empty()) {
+        if (mask.size() == (size_t)layout.Count()) {
             sf::VertexArray pathVa(sf::PrimitiveType::Triangles);
             sf::Color pc = sf::Color::Red;
             pc.a = 170;
 
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
-                    int idx = ml::ToIndex(x, y, w);
+            for (int y = sy0; y < cy1; y += stride) {
+                for (int x = sx0; x < cx1; x += stride) {
+                    int idx = layout.Index({x, y});
                     if (!mask[(size_t)idx]) continue;
                     if (maze.IsWall({x,y})) continue;
 
                     float x0 = x * m_tile;
                     float y0 = y * m_tile;
-                    float x1 = x0 + m_tile;
-                    float y1 = y0 + m_tile;
+                    float x1 = std::min(x + stride, w) * m_tile;
+                    float y1 = std::min(y + stride, h) * m_tile;
 
                     pathVa.append(sf::Vertex({x0,y0}, pc));
                     pathVa.append(sf::Vertex({x1,y0}, pc));
@@ -107,31 +135,35 @@ void Renderer::Draw(sf::RenderTarget& rt, const Simulation& sim, const sf::View&
         }
     }
 
-    // grid overlay
-    sf::VertexArray lines(sf::PrimitiveType::Lines);
-    const sf::Color gridC(255,255,255,28);
-    // vertical
-    for (int x = 0; x <= w; ++x) {
-        float X = x * m_tile;
-        lines.append(sf::Vertex({X, 0.f}, gridC));
-        lines.append(sf::Vertex({X, h * m_tile}, gridC));
-    }
-    for (int y = 0; y <= h; ++y) {
-        float Y = y * m_tile;
-        lines.append(sf::Vertex({0.f, Y}, gridC));
-        lines.append(sf::Vertex({w * m_tile, Y}, gridC));
+    // grid overlay (skipped when zoomed out far enough to sample)
+    if (stride == 1) {
+        sf::VertexArray lines(sf::PrimitiveType::Lines);
+        const sf::Color gridC(255,255,255,28);
+        // vertical
+        for (int x = cx0; x <= cx1; ++x) {
+            float X = x * m_tile;
+            lines.append(sf::Vertex({X, cy0 * m_tile}, gridC));
+            lines.append(sf::Vertex({X, cy1 * m_tile}, gridC));
+        }
+        for (int y = cy0; y <= cy1; ++y) {
+            float Y = y * m_tile;
+            lines.append(sf::Vertex({cx0 * m_tile, Y}, gridC));
+            lines.append(sf::Vertex({cx1 * m_tile, Y}, gridC));
+        }
+        rt.draw(lines);
     }
-    rt.draw(lines);
 
     // draw start/exit
     sf::RectangleShape mark({m_tile, m_tile});
     mark.setFillColor(sf::Color(80,200,120,200));
-    mark.setPosition({1.f * m_tile, 1.f * m_tile});
+    const CellPos start = sim.GetStart();
+    mark.setPosition({(float)start.x * m_tile, (float)start.y * m_tile});
     rt.draw(mark);
 
+    const CellPos exitPos = sim.GetExit();
     sf::RectangleShape exit({m_tile, m_tile});
     exit.setFillColor(sf::Color(220,120,120,220));
-    exit.setPosition({(float)(w-2) * m_tile, (float)(h-2) * m_tile});
+    exit.setPosition({(float)exitPos.x * m_tile, (float)exitPos.y * m_tile});
     rt.draw(exit);
 
     // draw agent
@@ -0,0 +1,273 @@
+// Regression checks for the simulation logic (no GUI). Built with
+// MAZELAB_BUILD_TESTS and run by ctest; exits non-zero on the first failing
+// group and prints every failed check.
+#include "core/CellLayout.h"
+#include "core/Maze.h"
+#include "core/MazeComponents.h"
+#include "core/MazeFile.h"
+#include "generators/CellularAutomataGenerator.h"
+#include "generators/PrimGenerator.h"
+#include "generators/RecursiveBacktrackerGenerator.h"
+#include "pathfinding/AStarPathfinder.h"
+#include "pathfinding/BatchPathfinding.h"
+#include "pathfinding/BFSPathfinder.h"
+#include "pathfinding/BidirectionalAStarPathfinder.h"
+#include "pathfinding/BidirectionalBFSPathfinder.h"
+#include "pathfinding/CorridorPathfinder.h"
+#include "pathfinding/HPAPathfinder.h"
+#include "pathfinding/JPSPathfinder.h"
+#include "sim/Leaderboard.h"
+#include "sim/MazeCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <memory>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);     \
+            ++g_failures;                                                            \
+        }                                                                            \
+    } while (0)
+
+void LayoutRoundTripAtMaxSide() {
+    constexpr int side = ml::CellLayout::kMaxSide;
+    ml::Maze maze(side, side);
+    CHECK(maze.Width() == side && maze.Height() == side);
+    const ml::CellLayout& layout = maze.Layout();
+    CHECK(static_cast<int64_t>(layout.Count()) ==
+          int64_t{ml::CellLayout::kMaxTilesPerSide} * ml::CellLayout::kMaxTilesPerSide * ml::CellLayout::kTileCells);
+
+    // far corner, tile edges and the padding ring
+    const int probes[] = {-1, 0, 1, 62, 63, 64, 4095, 40000, side - 65, side - 2, side - 1, side};
+    for (int y : probes) {
+        for (int x : probes) {
+            const ml::CellPos p{x, y};
+            const int idx = layout.Index(p);
+            CHECK(idx >= 0 && idx < layout.Count());
+            CHECK(layout.Pos(idx) == p);
+        }
+    }
+
+    // index-based neighbours agree with the position-based ones
+    const ml::CellPos corner{side - 2, side - 2};
+    maze.SetFree(corner, true);
+    maze.SetFree({side - 2, side - 1}, true);
+    maze.SetFree({side - 1, side - 2}, true);
+    maze.SetFree({side - 3, side - 2}, true);
+    for (ml::CellPos p : {corner, ml::CellPos{side - 1, side - 2}, ml::CellPos{side - 3, side - 2}}) {
+        CHECK(maze.OpenDirsAt(layout.Index(p)) == maze.OpenDirs(p));
+        CHECK(maze.OpenDirs(p) != 0);
+    }
+    const int ci = layout.Index(corner);
+    CHECK(layout.Pos(layout.Step(ci, ml::Dir::E)) == (ml::CellPos{side - 1, side - 2}));
+    CHECK(layout.Pos(layout.Step(ci, ml::Dir::S)) == (ml::CellPos{side - 2, side - 1}));
+}
+
+void StorageBeyondIndexSpace() {
+    // 100k x 100k: chunk-addressed storage only, memory follows what is carved
+    constexpr int side = 100001;
+    ml::Maze big(side, side);
+    CHECK(big.Width() == side && big.Height() == side);
+    CHECK(!big.Indexed());
+    for (int x = side - 70; x < side - 1; ++x) big.SetFree({x, side - 2}, true);
+    big.SetFree({side - 2, side - 3}, true);
+    CHECK(big.IsFree({side - 2, side - 2}) && big.IsWall({side - 1, side - 2}) && big.IsWall({0, 0}));
+    CHECK(big.OpenDirs({side - 2, side - 2}) == (ml::DirBit(ml::Dir::N) | ml::DirBit(ml::Dir::W)));
+    CHECK(big.OpenDirs({side - 2, side - 1}) == ml::DirBit(ml::Dir::N)); // border tile, a wall
+    CHECK(((big.RowWord(side - 2, (side - 2) / 64) >> ((side - 2) % 64)) & 1u) == 1u);
+    CHECK(big.AllocatedChunks() <= 6);
+    CHECK(big.MemoryBytes() < (size_t{32} << 20));
+    CHECK(big.Components().Count() == 0);
+
+    // per-tile searches need an index space and refuse; HPA* reads tiles directly
+    ml::Maze wide(ml::CellLayout::kMaxSide + 1000, 3);
+    CHECK(!wide.Indexed());
+    for (int x = 1; x < wide.Width() - 1; ++x) wide.SetFree({x, 1}, true);
+    const ml::CellPos a{1, 1};
+    const ml::CellPos b{wide.Width() - 2, 1};
+    CHECK(!ml::AStarPathfinder().FindPath(wide, a, b).found);
+    const ml::PathResult hpa = ml::HPAPathfinder().FindPath(wide, a, b);
+    CHECK(hpa.found);
+    CHECK(hpa.path.size() == static_cast<size_t>(b.x - a.x + 1));
+    CHECK(!hpa.path.empty() && hpa.path.back() == b);
+}
+
+ml::Maze MakeCave(int side, uint32_t seed) {
+    ml::Maze cave;
+    ml::MazeGenConfig gc;
+    gc.width = side;
+    gc.height = side;
+    gc.seed = seed;
+    gc.start = {1, 1};
+    gc.exit = {side - 2, side - 2};
+    ml::CellularAutomataGenerator().Generate(cave, gc);
+    return cave;
+}
+
+void PathfindersOnMappedView() {
+    const ml::Maze cave = MakeCave(257, 11);
+    const std::string path = (std::filesystem::temp_directory_path() / "mazelab_view_test.mlzb").string();
+    CHECK(ml::SaveMazeBinary(path, cave, ml::MazeMeta{}));
+    ml::MazeView view;
+    CHECK(view.Open(path));
+    CHECK(view.Indexed());
+    CHECK(view.Fingerprint() == cave.Fingerprint());
+
+    std::vector<ml::PathQuery> queries;
+    for (int i = 0; i < 48; ++i) {
+        const ml::CellPos a{1 + (i * 37) % 255, 1 + (i * 91) % 255};
+        const ml::CellPos b{1 + (i * 53 + 17) % 255, 1 + (i * 29 + 101) % 255};
+        if (cave.IsFree(a) && cave.IsFree(b)) queries.push_back({a, b});
+    }
+    CHECK(queries.size() > 8);
+
+    std::vector<std::unique_ptr<ml::IPathfinder>> finders;
+    finders.push_back(std::make_unique<ml::BFSPathfinder>());
+    finders.push_back(std::make_unique<ml::AStarPathfinder>());
+    finders.push_back(std::make_unique<ml::BidirectionalBFSPathfinder>());
+    finders.push_back(std::make_unique<ml::BidirectionalAStarPathfinder>());
+    finders.push_back(std::make_unique<ml::JPSPathfinder>());
+    finders.push_back(std::make_unique<ml::CorridorPathfinder>());
+    finders.push_back(std::make_unique<ml::HPAPathfinder>());
+    for (const auto& pf : finders) {
+        std::vector<ml::PathResult> onMaze(queries.size());
+        std::vector<ml::PathResult> onView(queries.size());
+        ml::FindPaths(*pf, cave, queries, onMaze);
+        ml::FindPaths(*pf, view, queries, onView);
+        size_t found = 0;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            CHECK(onMaze[i].found == onView[i].found);
+            CHECK(onMaze[i].path == onView[i].path);
+            found += onView[i].found ? 1u : 0u;
+        }
+        CHECK(found > queries.size() / 2);
+    }
+    view.Close();
+    std::filesystem::remove(path);
+}
+
+void MazeCacheCountsComponents() {
+    ml::Maze cave;
+    ml::MazeGenConfig gc;
+    gc.width = 301;
+    gc.height = 301;
+    gc.seed = 7;
+    gc.start = {1, 1};
+    gc.exit = {299, 299};
+    ml::CellularAutomataGenerator().Generate(cave, gc);
+    cave.Components(); // built already unless the generator had to connect start and exit
+
+    const size_t labels = static_cast<size_t>(cave.Layout().Count()) * sizeof(int);
+    CHECK(cave.MemoryBytes() >= labels);
+
+    ml::MazeCache cache(size_t{64} << 20);
+    cache.Insert({2, gc.width, gc.height, gc.seed, false}, cave);
+    CHECK(cache.Size() == 1);
+    CHECK(cache.UsedBytes() == cave.MemoryBytes());
+    CHECK(cache.UsedBytes() >= labels);
+
+    // a budget that only fits the chunks must not take the maze
+    ml::MazeCache small(cave.MemoryBytes() - labels / 2);
+    small.Insert({2, gc.width, gc.height, gc.seed, false}, cave);
+    CHECK(small.Size() == 0);
+}
+
+// Run in small slices, a task must build exactly the maze Generate() does.
+void SlicedTaskMatchesGenerate(ml::IMazeGenerator& gen, const ml::MazeGenConfig& gc) {
+    ml::Maze whole;
+    gen.Generate(whole, gc);
+
+    auto task = gen.Begin(gc);
+    int steps = 0;
+    float last = 0.f;
+    while (!task->Step(1 << 10)) {
+        ++steps;
+        CHECK(task->Progress() >= last);
+        last = task->Progress();
+    }
+    CHECK(steps > 1);
+    ml::Maze sliced;
+    task->Finish(sliced);
+    CHECK(sliced.Fingerprint() == whole.Fingerprint());
+    CHECK(sliced.OpenDirs(gc.start) == whole.OpenDirs(gc.start));
+    CHECK(sliced.Components().Connected(gc.start, gc.exit));
+}
+
+void GenerationTasksAreSliced() {
+    ml::MazeGenConfig gc;
+    gc.width = 301;
+    gc.height = 257;
+    gc.start = {1, 1};
+    gc.exit = {299, 255};
+    for (uint32_t seed : {1u, 2u, 3u, 4u}) {
+        gc.seed = seed;
+        ml::CellularAutomataGenerator cave;
+        SlicedTaskMatchesGenerate(cave, gc);
+
+        gc.tiled = true;
+        ml::RecursiveBacktrackerGenerator dfs;
+        SlicedTaskMatchesGenerate(dfs, gc);
+        ml::PrimGenerator prim;
+        SlicedTaskMatchesGenerate(prim, gc);
+        gc.tiled = false;
+    }
+}
+
+void LeaderboardUpgradesOldHeader() {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "mazelab_test_leaderboard.csv").string();
+    {
+        std::ofstream old(path, std::ios::binary | std::ios::trunc);
+        old << "timestamp,width,height,generator,visibility,agent,seed,random_seed,"
+               "status,steps,path_length,visited_unique,expanded_nodes,replans,duration_ms\n"
+               "2024-01-01T00:00:00,31,31,\"DFS\",full,\"A*\",1,0,Success,10,10,12,40,0,1.5\n";
+    }
+
+    ml::LeaderboardEntry e;
+    e.timestampIso = "2024-01-02T00:00:00";
+    e.cfg.mazeFingerprint = 0xabcull;
+    ml::Leaderboard(path).Append(e);
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) lines.push_back(line);
+    auto columns = [](const std::string& line) {
+        return 1 + static_cast<int>(std::count(line.begin(), line.end(), ','));
+    };
+    CHECK(lines.size() == 3);
+    if (lines.size() == 3) {
+        CHECK(lines[0].ends_with(",maze_fingerprint"));
+        CHECK(columns(lines[1]) == 16 && lines[1].ends_with(","));
+        CHECK(columns(lines[2]) == 16 && lines[2].ends_with("0000000000000abc"));
+    }
+    in.close();
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+int main() {
+    LayoutRoundTripAtMaxSide();
+    StorageBeyondIndexSpace();
+    PathfindersOnMappedView();
+    MazeCacheCountsComponents();
+    GenerationTasksAreSliced();
+    LeaderboardUpgradesOldHeader();
+    if (g_failures) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}